@@ -9,9 +9,36 @@
 #ifndef BBNODE_H_
 #define BBNODE_H_
 
+#include <memory>
+#include <stdint.h>
+
 #include "inst.h"
 #include "ds.h"
 
+// dual ascent solution of a node, given by the amounts of arc costs and node revenues it consumed
+struct DualState {
+	vector<pair<int,weight_t>> arcs, nodes;
+	weight_t lb;
+	int arcMoves;
+	// for duals of a previous solve, the structureHash of the instance they were computed on
+	uint64_t structure = 0;
+};
+
+// branching decisions leading to a node, recorded to describe the regions of the search space closed
+// by the search (see reopt.h). Nodes share the decisions of their ancestors.
+struct BranchPath {
+	enum Kind { EXCLUDE, ROOT, OUT, IN };   // root forbidden, root chosen, node removed, node fixed
+
+	int v;
+	Kind kind;
+	shared_ptr<const BranchPath> parent;
+
+	static shared_ptr<const BranchPath> extend(const shared_ptr<const BranchPath>& parent, int v, Kind kind)
+	{
+		return make_shared<const BranchPath>(BranchPath{v, kind, parent});
+	}
+};
+
 class BBNode {
 public:
 	weight_t lb = 0.0;
@@ -24,6 +51,25 @@ public:
 	int v2 = -1;
 	Inst* inst;
 
+	// stored nodes (inst == nullptr) are represented by the base instance of their subtree,
+	// the difference to it and the branching decision, if it is not yet applied (pending)
+	shared_ptr<const Inst>     base;
+	shared_ptr<const InstDiff> diff;
+	bool pending = false;
+	// the instance is kept although it is stored, the stored one lacks only the branching decision
+	bool kept = false;
+	// position and size of the record of a spilled node, whose difference and duals were moved to
+	// a spill file (see spill.h), -1 if it is not spilled
+	int64_t spillPos = -1, spillSize = 0;
+
+	// duals of the processed parent, used to warm-start dual ascent
+	shared_ptr<const DualState> duals;
+
+	// branching decisions of the node, null if they are not recorded
+	shared_ptr<const BranchPath> path;
+	// structure of the instance of a root after the reduction tests, if its regions are recorded
+	uint64_t rootHash = 0;
+
 	// queue positions in B&B
 	PQMin<weight_t,BBNode*>::handle_type pqposMin;
 	PQMax<weight_t,BBNode*>::handle_type pqposMax;
@@ -38,6 +84,15 @@ public:
 
 	// updates instance graph size
 	void updateNodeSize();
+
+	// applies the branching decision to the instance, deferred if the node is stored
+	void applyBranch();
+
+	// replaces the instance by its difference to the base instance and restores it again
+	void store();
+	void restore();
+	// stores the instance but keeps it, nodes created from it share the stored instance
+	void keep();
 };
 
 #endif // BBNODE_H_
@@ -10,11 +10,22 @@
 #define BBTREE_H_
 
 #include <random>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <tuple>
 
 #include "inst.h"
 #include "sol.h"
 #include "bbnode.h"
+#include "reopt.h"
+#include "board.h"
+#include "spill.h"
 #include "options.h"
+#include "timer.h"
+#include "parallel.h"
+#include "procstatus.h"
 
 class BBTree
 {
@@ -24,11 +35,17 @@ public:
 	enum NodeState { BB_INFEAS, BB_CUTOFF, BB_LEAF, BB_BRANCH };
 
 	BBTree(Inst& inst);
+	// creates a worker operating on its own copy of the instance, which shares the incumbent with master
+	BBTree(BBTree& master, Inst& inst, int id);
 	~BBTree();
 
 	void     processRoots();
 	void     initHeur();
 	int      initPrep();
+	// replaces the initial preprocessing by loading a snapshot of its result
+	void     loadPrep(const char* fn);
+	// writes a snapshot of the preprocessed instance and its backmapping
+	void     savePrep(const char* fn);
 	void     solve();
 
 	// setters
@@ -36,16 +53,41 @@ public:
 	void     setNodeLim(int i)        { nodeLim = i; }
 	void     setTimeLim(double d)     { if(d < 0) timeLim = DMAX; else timeLim = d; }
 
-	void     setIncumbent(Sol& sol)   { inc = sol; ub = inc.obj; }
+	// sets the incumbent on the instance before preprocessing
+	void     setIncumbent(Sol& sol);
 	void     setOutput(bool b)        { bOutput = b; }
 	void     setCutUp(weight_t d)     { cutup = d; }
 	void     setRecover(bool b)       { bRecover = b; }
 	void     setBestKnown(double d)   { bestKnown = d; }
+	// f is called with the objective of each new incumbent, calls are serialized and in the order of
+	// improvement, a solution replaced while it was reported is not reported
+	void     setIncumbentCallback(function<void(weight_t)> f) { incumbentCallback = f; }
+	// the solve stops like at the time limit once *flag is set
+	void     setCancelFlag(const atomic<bool>* flag) { cancel = flag; }
+	// member k of a portfolio: exchanges bounds through p and stops once p->stop is set, i.e. once
+	// another member is optimal or has failed
+	void     setPortfolio(PortfolioBounds* p, int k) { portfolio = p; portfolioIndex = k; }
+	// takes the bounds of the other members, e.g. after the portfolio has been stopped
+	void     importPortfolioBounds();
+
+	// reoptimization (see reopt.h): records the regions closed by the search and the root duals
+	void     recordState()            { bRecord = true; bPaths = true; }
+	// takes the incumbent of a state written for the instance with other weights, if it is still
+	// feasible, and reuses its regions in solve. Called before preprocessing, s must outlive the tree.
+	void     setReoptState(const ReoptState& s);
+	void     saveReoptState(const char* fn);
+	// checkpoints: the incumbent, the open nodes and the branching priorities are written to fn every
+	// freq seconds of the B&B and once it ends, in the background while the search continues
+	void     setCheckpoint(const string& fn, double freq) { checkpointFile = fn; checkpointFreq = freq; bPaths = true; }
+	// continues the search of a checkpoint written for the same instance and parameters. Called
+	// before preprocessing, its incumbent is applied once the roots are reached (like the heuristics,
+	// preprocessing then yields the same instance as before), s must outlive the tree.
+	void     setResume(const ReoptState& s);
 
 	// getters
 	int      getNnodes()          { return nIter; }
 	double   getTime()            { return bbTime; }
-	double   getTimeBest()        { return timeBestSol; }
+	double   getTimeBest();
 	double   getHeurTime()        { return heurTime; }
 	double   getRootTime()        { return rootTime; }
 	double   getHeurBBTime()      { return heurBBTime; }
@@ -57,14 +99,14 @@ public:
 	weight_t getLBM()             { return lbM; }
 	weight_t getRootUB()          { return rootub; }
 	weight_t getRootLB()          { return rootlb; }
-	Sol      getSol()             { return inc; }
+	Sol      getSol()             { syncIncumbent(); return inc; }
 	State    getState()           { return tState; }
 	int      getNroots()          { return nRoots; }
 	int      getNrootsProcessed() { return nRootsProcessed; }
 	int      getNrootsOpen()      { return nRootsOpen; }
 
 	Inst&    getInst1()           { return inst1; }
-	Sol&     getInc1()            { return inc1; }
+	Sol&     getInc1()            { syncOriginal(); return inc1; }
 
 private:
 
@@ -75,9 +117,12 @@ private:
 	PQMax<weight_t,BBNode*> PQmax;
 	PQMin<weight_t,BBNode*> PQmin;
 
-	// incumbent on preprocessed and unpreprocessed graph
+	// incumbent on preprocessed and unpreprocessed graph, copies of the incumbent on the board
 	Sol inc, inc1;
+	int inc1Version = 0;
+	shared_ptr<BoundBoard> board;
 	vector<Sol*> pool;
+	function<void(weight_t)> incumbentCallback;
 
 	mt19937 rndGen;
 
@@ -89,9 +134,10 @@ private:
 	int      bestSingleNodeSolNode;
 	weight_t cutup = -1.0;
 
-	double bbTime, timeBestSol, heurTime, heurBBTime, rootTime;
+	double bbTime, heurTime, heurBBTime, rootTime;
 	int    nRoots, nRootsProcessed, nRootsOpen;
-	int    nImprovements, nIter;
+	int    nIter;
+	atomic<int> nImprovements{0};
 
 	weight_t lbM = -1;
 	Inst instM;
@@ -100,6 +146,11 @@ private:
 	vector<int> prio;
 	vector<weight_t> cr, pi;
 	vector<double> crf, pif;
+	// pseudo-costs of --bb.branchtype 4: sum and number of the bound gains of the probes per node,
+	// for removing (0) and fixing (1) it, and the instance the probes are run on (see selectReliable)
+	vector<double> pcSum[2];
+	vector<int>    pcCnt[2];
+	Inst           probeInst;
 
 	// states
 	bool processedRoots = false;
@@ -110,27 +161,100 @@ private:
 	// disables all output to terminal
 	bool bOutput = true;
 
+	// reoptimization, record is filled if bRecord is set, reopt is the state of a previous solve.
+	// Branching decisions are tracked if bPaths is set, for recording or for checkpoints
+	bool bRecord = false;
+	bool bPaths = false;
+	bool bResume = false;
+	bool bRootsComplete = false;
+	mutex mtxRecord;
+	ReoptState record;
+	const ReoptState* reopt = nullptr;
+	void    recordPrep();
+	void    closeRegion(const shared_ptr<const BranchPath>& path, weight_t lb);
+	void    addRegion(const shared_ptr<const BranchPath>& path, weight_t lb);
+	void    recordRoot(int r, const BBNode* b);
+	bool    reoptRoots();
+	bool    stateIncumbent(const ReoptState& s, Sol& sol);
+	Sol     originalIncumbent();
+
+	// checkpoints, written on a thread of their own
+	string  checkpointFile;
+	double  checkpointFreq = 0;
+	Timer   tCheckpoint;
+	unique_ptr<ThreadGroup> checkpointWriter;
+	bool    checkpointDue()           { return !checkpointFile.empty() && !bHeur && tCheckpoint.elapsed().getSeconds() >= checkpointFreq; }
+	vector<ReoptRegion> openRegions();
+	void    writeCheckpoint(vector<ReoptRegion> regions, const vector<int>& prio);
+
 	// limits
 	int nodeLim, solLim; double timeLim;
+	const atomic<bool>* cancel = nullptr;
+	bool    cancelled() const         { return (cancel != nullptr && *cancel) || (portfolio != nullptr && portfolio->stop); }
+	bool    timeUp(const Timer& t)    { return t.elapsed().getSeconds() > timeLim || cancelled(); }
+	// memory of the solve in MB, its share of the process (see ProcStatus::share): the resident memory
+	// if open nodes may be spilled (see spillNodes), which only reduces that, the virtual size otherwise
+	u_int   memUsed() const           { return ProcStatus::share((params.spill > 0 && params.bbtrail) ? ProcStatus::resident() : ProcStatus::mem()); }
+	// --memlimit is the limit of the process, the --jobs solves of batch and server mode get equal parts
+	u_int   memLimit() const          { return params.memlimit / max(1, params.jobs); }
+
+	// child of the last node, which keeps the instance of its parent until the next node is selected
+	// and which the hybrid node selection continues with (see select)
+	BBNode* plungeNode = nullptr;
+
+	// open nodes spilled near the memory limit (see spill.h), the file of the master is shared
+	unique_ptr<NodeSpill> spill;
+	NodeSpill* spillFile()            { return (master != nullptr) ? master->spill.get() : spill.get(); }
+	void    spillNodes();
+
+	PortfolioBounds* portfolio = nullptr;
+	int     portfolioIndex = -1;
+
+	// parallel processing (workers share the board of their master and publish improving solutions on it)
+	class   RootSpeculation;
+	class   ParallelSearch;
+	class   AsyncHeur;
+	BBTree* master = nullptr;
+	ParallelSearch* search = nullptr;
+	// heuristic threads of the master while the tree is searched (--heur.async)
+	AsyncHeur* heur = nullptr;
+	// guards inc and ub while they are changed, as root speculation reads them from the master
+	mutex   mtxInc;
+	mutex   mtxCallback;
+	int     incVersion = 0;
+	void    syncIncumbent();
+	void    syncOriginal();
+	int     processRootsParallel(vector<int>& roots, Timer& tRoot, int& covered);
+	void    solveParallel(Timer& tBB);
+	int     openNodes();
 
 	// node operations
 	BBNode*           select();
 	BBTree::NodeState process(BBNode* b);
 	void              add(BBNode* b);
 	int               selectBranchVariable(BBNode* b);
+	int               selectReliable(BBNode* b, vector<tuple<int,int,int,int>>& cands);
+	weight_t          probe(BBNode* b, int v, int bdir);
 	void              branch(BBNode* b);
 	void              evalLeaf(BBNode* b);
 	BBTree::NodeState strengthenBounds(BBNode* b);
-	BBNode*           makeRoot(int r, weight_t lb, vector<int>& fe0);
+	bool              warmStart(BBNode* b);
+	void              saveDuals(BBNode* b, weight_t lb);
+	BBNode*           makeRoot(int r, weight_t lb, vector<int>& fe0, shared_ptr<const BranchPath> path = nullptr);
 
 	// general operations
 	void              freeOpenNodes();
 	bool              updatePrimal(Inst& inst, Sol& sol);
+	// publishes sol on the board without updating the copies of the tree, may be called concurrently
+	bool              publishPrimal(Inst& inst, Sol& sol);
 	int               preprocess(Inst& inst);
+	void              initSemiBigM();
 	bool              isFeas(Inst& inst, bool bDoNRtest = true);
 	vector<weight_t>  setSupportGraph(Inst& inst);
 	vector<weight_t>  setSupportGraphf(Inst& inst, vector<double>& cr);
 	weight_t          perturbedPrimalHeur(Inst& inst);
+	// primI on the support graph of a dual ascent with costs perturbed by guide, only uses its arguments
+	Sol               perturbedSol(Inst& inst, Sol& guide, vector<double>& crf, vector<double>& pif, weight_t ub);
 	vector<int>       sortedListPotentialRoots();
 	void              fixTerm(Inst& inst, int t, vector<int>& fe0);
 
@@ -0,0 +1,102 @@
+/**
+ * \file   board.h
+ * \brief  incumbent and upper bound shared by the concurrent components of a solve
+ *
+ * The upper bound is an atomic read by the pruning tests without locking. Incumbents are immutable
+ * once published and form a list, whose head is replaced by a compare-and-swap, so publishing never
+ * blocks and only succeeds for solutions better than the current head. Replaced incumbents stay valid
+ * until reclaim() is called by the owner of the board, when no other thread uses it.
+ *
+ * Publishing only collects the arcs of the original instance used by the solution, which depend on
+ * the (node) instance the solution was found on. The solution on the original instance is built from
+ * them when it is requested, once per incumbent.
+ *
+ * \author Martin Luipersbeck
+ * \date   2026-10-17
+ */
+
+#ifndef BOARD_H_
+#define BOARD_H_
+
+#include <atomic>
+#include <mutex>
+#include <limits>
+
+#include "inst.h"
+#include "sol.h"
+#include "util.h"
+
+// lowers a to b, or raises it, without locking
+template<typename T> void atomicMin(atomic<T>& a, T b)
+{
+	T cur = a.load(memory_order_relaxed);
+	while(b < cur && !a.compare_exchange_weak(cur, b, memory_order_acq_rel, memory_order_relaxed));
+}
+template<typename T> void atomicMax(atomic<T>& a, T b)
+{
+	T cur = a.load(memory_order_relaxed);
+	while(b > cur && !a.compare_exchange_weak(cur, b, memory_order_acq_rel, memory_order_relaxed));
+}
+
+class BoundBoard
+{
+public:
+	struct Incumbent
+	{
+		explicit Incumbent(const Sol& sol) : sol(sol) {}
+
+		Sol        sol;                 // on the preprocessed instance
+		SolSupport support;             // on the original instance, if bMapped
+		bool       bMapped = false;
+		int        version = 0;
+		double     time = 0.0;          // total time at which it was found
+		const Incumbent* prev = nullptr;
+	};
+
+	explicit BoundBoard(Inst& inst1) : inst1(inst1), orig(inst1) {}
+	~BoundBoard();
+
+	weight_t ub() const                    { return bound.load(memory_order_acquire); }
+	int      version() const               { return ver.load(memory_order_acquire); }
+	// for bound checks within long computations, e.g. the dual ascent
+	const atomic<weight_t>* liveUB() const { return &bound; }
+	const Incumbent* incumbent() const     { return head.load(memory_order_acquire); }
+
+	// publishes sol (found on inst) if it is better than the incumbent and the upper bound. The
+	// backmapping of inst is collected if bMap is set. Returns the published incumbent or nullptr.
+	const Incumbent* publish(Sol& sol, Inst& inst, bool bMap);
+	// replaces the incumbent and the upper bound regardless of their value (single-threaded)
+	void     reset(Sol& sol, Inst& inst);
+	// lowers the upper bound without a solution
+	void     cutUp(weight_t b);
+	// incumbent on the original instance and its version
+	Sol      original(int& version);
+	// frees the replaced incumbents, no other thread may use the board meanwhile
+	void     reclaim();
+
+private:
+	Inst& inst1;
+	atomic<weight_t> bound{WMAX};
+	atomic<int> ver{0};
+	atomic<const Incumbent*> head{nullptr};
+
+	// original incumbent, built on request
+	mutex mtxOrig;
+	Sol   orig;
+	int   origVersion = 0;
+};
+
+// bounds shared by the trees of a portfolio (--portfolio), which solve the same instance with different
+// parameters. Every tree preprocesses its own copy, so only objective values are exchanged: the best
+// upper bound is imported by the boards of all trees as cutoff, the best lower bound of any tree is
+// valid for all of them.
+struct PortfolioBounds
+{
+	atomic<weight_t> ub{WMAX};
+	atomic<weight_t> lb{numeric_limits<weight_t>::min()};
+	// set once a tree proved optimality, stops the others
+	atomic<bool>     stop{false};
+	atomic<int>      winner{-1};
+};
+
+#endif // BOARD_H_
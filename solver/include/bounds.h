@@ -15,7 +15,13 @@
 #include "sol.h"
 #include "options.h"
 
-// dual ascent
-template<typename U> weight_t daR(int r, Inst& inst, vector<U>& c, vector<U>& cr, vector<U>& pr, weight_t ub, double eager, Sol* inc, bool heur = false);
+#include <atomic>
+
+// dual ascent, if warm is set it continues from the reduced costs cr and pr given by the caller.
+// It stops once the bound reaches ub, or the value of ubLive if given, which is checked after
+// each component. A positive iterLim truncates it after the component in which this number of
+// augmentations is reached (components evaluated but not augmented do not count), the bound remains
+// valid.
+template<typename U> weight_t daR(int r, Inst& inst, vector<U>& c, vector<U>& cr, vector<U>& pr, weight_t ub, double eager, Sol* inc, bool heur = false, bool warm = false, const atomic<weight_t>* ubLive = nullptr, int iterLim = 0);
 
 #endif // BOUNDS_H_
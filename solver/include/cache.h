@@ -0,0 +1,45 @@
+/**
+ * \file   cache.h
+ * \brief  binary cache of loaded instances (.stpb files), presolve snapshots and reoptimization states
+ *
+ * \author Martin Luipersbeck
+ * \date   2026-10-17
+ */
+
+#ifndef CACHE_H_
+#define CACHE_H_
+
+#include "def.h"
+#include "inst.h"
+#include "reopt.h"
+
+// path of the cache file belonging to an instance file (same path with extension .stpb)
+string cachePath(const char* fn);
+
+// loads the instance from its cache file, if it exists and was written for the current version of
+// the instance file with the same problem type and precision
+bool loadCache(const char* fn, Inst& inst);
+
+// like loadCache, but for the content of a cache file (without checking the version of the instance file)
+bool loadCacheData(const char* data, size_t size, Inst& inst);
+
+// whether data starts like a cache file
+bool isCacheData(const char* data, size_t size);
+
+// writes the loaded instance to its cache file
+void writeCache(const char* fn, const Inst& inst);
+
+// replaces inst by the preprocessed instance of a snapshot written for the same original instance
+// inst1, including its backmapping and reduction statistics. Returns false if the file is missing,
+// invalid or was written for a different instance.
+bool loadPresolved(const char* fn, const Inst& inst1, Inst& inst);
+
+// writes the preprocessed instance inst of the original instance inst1 to a snapshot file
+void writePresolved(const char* fn, const Inst& inst1, const Inst& inst);
+
+// reads a reoptimization state, returns false if the file is missing, invalid or was written for
+// a different problem type or precision
+bool loadReoptState(const char* fn, ReoptState& s);
+void writeReoptState(const char* fn, const ReoptState& s);
+
+#endif // CACHE_H_
@@ -0,0 +1,26 @@
+/**
+ * \file   dakernels.h
+ * \brief  vectorized kernels of the dual ascent augmentation
+ *
+ * \author Martin Luipersbeck
+ * \date   2026-10-17
+ */
+
+#ifndef DAKERNELS_H_
+#define DAKERNELS_H_
+
+#include "def.h"
+
+// The kernels operate on the reduced costs of the cut arcs of a component, which dual ascent keeps
+// contiguously while the component is augmented. AVX-512 or AVX2 versions are chosen at runtime
+// depending on the CPU (and --da.simd), otherwise scalar loops are used. All versions give
+// identical results.
+
+// minimum of a[0],...,a[n-1], the maximum value of U if n is 0
+template<typename U> U minValue(const U* a, int n);
+
+// subtracts delta from a[0],...,a[n-1] and stores the positions i with a[i] <= sat in s,
+// the number of these positions is returned
+template<typename U> int subtractSaturate(U* a, int n, U delta, U sat, int* s);
+
+#endif // DAKERNELS_H_
@@ -0,0 +1,90 @@
+/**
+ * \file   dapcstp.h
+ * \brief  library interface of the solver
+ *
+ * \author Martin Luipersbeck
+ * \date   2026-10-17
+ */
+
+#ifndef DAPCSTP_H_
+#define DAPCSTP_H_
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <atomic>
+
+namespace dapcstp {
+
+// (rooted) prize-collecting Steiner tree instance, nodes are numbered 0,...,nNodes-1
+struct Problem {
+	int nNodes = 0;
+
+	// edges, or arcs if directed, and their cost
+	std::vector<int>    tail, head;
+	std::vector<double> cost;
+	bool directed = false;
+
+	// prize of each node
+	std::vector<double> prize;
+
+	// node contained in every solution, -1 if unrooted
+	int root = -1;
+};
+
+enum class Status { Optimal, TimeLimit, NodeLimit, MemLimit, Cancelled, Error };
+
+struct Statistics {
+	int    bbNodes = 0;
+	int    nodesPrep = 0, arcsPrep = 0;  // instance size after the initial preprocessing
+	double rootLB = 0.0, rootUB = 0.0;
+	double time = 0.0, timeBest = 0.0, prepTime = 0.0, heurTime = 0.0, rootTime = 0.0, bbTime = 0.0;
+};
+
+struct Result {
+	Status      status = Status::Error;
+	std::string error;                   // message if status is Error
+
+	double objective = 0.0, lowerBound = 0.0, gap = 100.0;
+	std::vector<char> nodes;             // nodes[i] = 1 if node i is part of the solution
+	std::vector<char> edges;             // edges[e] = 1 if edge (arc) e is part of the solution, only for Problem
+	std::string solution;                // solution in the format of the file written with -o
+
+	Statistics  stats;
+	std::string statsLine;               // row of the statistics file written with --stats
+};
+
+// Solves problems with a set of options. Solvers keep no global state, several solves can run
+// concurrently on separate threads.
+class Solver {
+public:
+	// sets an option by its command line name, e.g. setOption("timelimit", "60") for --timelimit 60
+	void setOption(const std::string& name, const std::string& value);
+
+	// sets options given in command line form, e.g. {"--timelimit", "60", "--rootonly"}. Invalid options
+	// and --help make solve() return Status::Error.
+	void setArguments(const std::vector<std::string>& args);
+
+	// f is called with the objective and time (in seconds) of each new incumbent. It is called from
+	// the solving threads and must not block.
+	void setIncumbentCallback(std::function<void(double objective, double time)> f);
+
+	// a solve stops with status Cancelled once *flag is set, which may happen from any thread
+	void setCancelFlag(const std::atomic<bool>* flag);
+
+	// solves the problem on the calling thread, errors are reported by the status of the result
+	Result solve(const Problem& problem) const;
+
+	// solves the instance given by the content of an instance file of the type set by the option
+	// "type", or of a binary cache file (.stpb)
+	Result solve(const char* data, size_t size) const;
+
+private:
+	std::vector<std::string> options;
+	std::function<void(double, double)> incumbentCallback;
+	const std::atomic<bool>* cancel = nullptr;
+};
+
+} // namespace dapcstp
+
+#endif // DAPCSTP_H_
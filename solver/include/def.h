@@ -13,6 +13,9 @@
 #include <string>
 #include <sstream>
 #include <iostream>
+#include <stdexcept>
+#include <cstdarg>
+#include <cstdio>
 
 #define PROGRAM_NAME "da"
 #define PROGRAM_VERSION "1.0"
@@ -35,9 +38,42 @@
 #define IMAX std::numeric_limits<int>::max()
 #define gap(lb,ub) ((double)abs(ub-lb)/ub)
 #define gapP(lb,ub) ((double)abs(ub-lb)*100.0/ub)
-#define EXIT(...) {fprintf(stderr, __VA_ARGS__);exit(1);}
+#define EXIT(...) throw SolverError(formatMessage(__VA_ARGS__))
 
 typedef long weight_t;
 typedef char flag_t;
 
+// errors abort the current solve by throwing a SolverError (see EXIT), which the executable
+// prints before exiting and the library returns to its caller
+class SolverError : public std::runtime_error
+{
+public:
+	explicit SolverError(const std::string& msg) : std::runtime_error(msg) {}
+};
+
+inline std::string formatMessage(const char* format, ...)
+{
+	char buf[1024];
+	va_list args;
+	va_start(args, format);
+	vsnprintf(buf, sizeof(buf), format, args);
+	va_end(args);
+	return buf;
+}
+
+// appends printf-formatted output to s
+inline void appendf(std::string& s, const char* format, ...)
+{
+	va_list args, args2;
+	va_start(args, format);
+	va_copy(args2, args);
+	const int len = vsnprintf(nullptr, 0, format, args);
+	const size_t pos = s.size();
+	s.resize(pos + len + 1);
+	vsnprintf(&s[pos], len + 1, format, args2);
+	s.resize(pos + len);
+	va_end(args2);
+	va_end(args);
+}
+
 #endif // DEF_H_
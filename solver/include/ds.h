@@ -11,6 +11,13 @@
 
 #include "def.h"
 
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+#include <queue>
+#include <functional>
+#include <thread>
+
 #include <boost/heap/d_ary_heap.hpp>
 #include <boost/heap/fibonacci_heap.hpp>
 
@@ -44,4 +51,284 @@ template <typename T, typename U> using PQMax = boost::heap::d_ary_heap<pair<T,U
 
 template <typename T, typename U> using PQMinFib = boost::heap::fibonacci_heap<pair<T,U>, boost::heap::mutable_<true>, boost::heap::compare<smallestFirst<T,U>>>;
 
+// priority queue for the elements 0,...,n-1 (each contained at most once) with non-negative integer
+// keys, used with the interface of PQMin<int,int>. Keys below nBuckets are kept in buckets, linked
+// through the elements, larger keys in a heap. The pointer to the smallest non-empty bucket moves
+// down when a smaller key is inserted, so keys need not be monotone. Equal keys are returned LIFO.
+class BucketQueue
+{
+public:
+	BucketQueue(int n, int nBuckets) : head(nBuckets, -1), next(n), cur(nBuckets) {}
+
+	bool   empty() const { return nBucket == 0 && overflow.empty(); }
+	size_t size() const  { return nBucket + overflow.size(); }
+
+	void push(const pair<int,int>& e)
+	{
+		const int k = e.first, i = e.second;
+		if(k >= (int)head.size()) {
+			overflow.push(e);
+			return;
+		}
+		next[i] = head[k];
+		head[k] = i;
+		nBucket++;
+		if(k < cur) cur = k;
+	}
+
+	pair<int,int> top()
+	{
+		if(nBucket == 0) return overflow.top();
+		while(head[cur] == -1) cur++;
+		return make_pair(cur, head[cur]);
+	}
+
+	void pop()
+	{
+		if(nBucket == 0) {
+			overflow.pop();
+			return;
+		}
+		while(head[cur] == -1) cur++;
+		head[cur] = next[head[cur]];
+		nBucket--;
+	}
+
+	// removes all elements, the cost is proportional to the number of elements left
+	void clear()
+	{
+		while(nBucket > 0) pop();
+		overflow = decltype(overflow)();
+		cur = (int)head.size();
+	}
+
+	// grows the queue to hold nodes 0,...,n-1 and keys below nBuckets in buckets (requires an empty queue)
+	void resize(int n, int nBuckets)
+	{
+		if((int)next.size() < n) next.resize(n);
+		if((int)head.size() < nBuckets) head.resize(nBuckets, -1);
+		cur = (int)head.size();
+	}
+
+private:
+	vector<int> head, next;
+	int cur, nBucket = 0;
+	priority_queue<pair<int,int>, vector<pair<int,int>>, greater<pair<int,int>>> overflow;
+};
+
+// adjacency lists of all nodes stored in a single array (compressed sparse row layout): node i owns
+// the segment of size cap[i] starting at beg[i], of which the first len[i] entries are in use.
+// Lists are accessed through views offering the interface of vector<int>, so positions within a
+// list (pin/pout) keep their meaning. A list outgrowing its segment is moved to the end of the
+// array, which is compacted once more than half of it is unused. Copies are always compacted.
+class Adjacency
+{
+public:
+	template<typename A, typename P>
+	class View
+	{
+	public:
+		View(A& adj, int i) : adj(adj), i(i) {}
+
+		P    begin() const { return adj.data.data() + adj.beg[i]; }
+		P    end()   const { return begin() + adj.len[i]; }
+		int  size()  const { return adj.len[i]; }
+		bool empty() const { return adj.len[i] == 0; }
+
+		typedef typename remove_pointer<P>::type& Ref;
+
+		Ref  operator[](int k) const { return begin()[k]; }
+		Ref  front() const           { return begin()[0]; }
+		Ref  back() const            { return begin()[adj.len[i]-1]; }
+
+		void push_back(int ij) const { adj.push(i, ij); }
+		void pop_back() const        { adj.len[i]--; adj.nUsed--; }
+		void clear() const           { adj.nUsed -= adj.len[i]; adj.len[i] = 0; }
+		// unused space is reclaimed by compaction
+		void shrink_to_fit() const   {}
+
+	private:
+		A& adj;
+		const int i;
+	};
+
+	typedef View<Adjacency, int*> List;
+	typedef View<const Adjacency, const int*> ConstList;
+
+	Adjacency() {}
+	Adjacency(const Adjacency& adj) { *this = adj; }
+	Adjacency(Adjacency&&) = default;
+	Adjacency& operator=(Adjacency&&) = default;
+
+	Adjacency& operator=(const Adjacency& adj)
+	{
+		if(this == &adj)
+			return *this;
+
+		len = adj.len;
+		cap = adj.len;
+		beg.resize(adj.beg.size());
+		data.resize(adj.nUsed);
+		int pos = 0;
+		for(int i = 0; i < (int)beg.size(); i++) {
+			copy_n(adj.data.begin() + adj.beg[i], len[i], data.begin() + pos);
+			beg[i] = pos;
+			pos += len[i];
+		}
+		nUsed = adj.nUsed;
+		return *this;
+	}
+
+	List      operator[](int i)       { return List(*this, i); }
+	ConstList operator[](int i) const { return ConstList(*this, i); }
+
+	int size() const { return (int)beg.size(); }
+
+	void resize(int n)
+	{
+		for(int i = n; i < size(); i++) {
+			nUsed -= len[i];
+		}
+		beg.resize(n, (int)data.size());
+		len.resize(n, 0);
+		cap.resize(n, 0);
+	}
+
+	// replaces list i by the given elements
+	void assign(int i, const vector<int>& v)
+	{
+		assign(i, v.data(), (int)v.size());
+	}
+
+	// replaces list i by the k elements starting at v
+	void assign(int i, const int* v, int k)
+	{
+		if(k > cap[i]) relocate(i, k);
+		copy_n(v, k, data.begin() + beg[i]);
+		nUsed += k - len[i];
+		len[i] = k;
+	}
+
+	// builds the lists of n nodes from elements 0,...,m-1, where element k is appended to list key[k];
+	// pos[k] is set to its position within the list. With nThreads > 1, consecutive blocks of
+	// elements are counted and distributed on separate threads, which yields the same lists.
+	void build(int n, const vector<int>& key, int m, vector<int>& pos, int nThreads = 1)
+	{
+		const int nBlocks = max(1, min(nThreads, m / (1 << 16)));
+		auto blockBegin = [m, nBlocks](int b) { return (int)((long)m * b / nBlocks); };
+
+		// cnt[b][i]: number of elements of block b in list i, later the position of its first one
+		vector<vector<int>> cnt(nBlocks, vector<int>(n, 0));
+		forBlocks(nBlocks, [&](int b) {
+			vector<int>& cntB = cnt[b];
+			for(int k = blockBegin(b); k < blockBegin(b+1); k++) {
+				cntB[key[k]]++;
+			}
+		});
+
+		beg.resize(n);
+		len.resize(n);
+		int total = 0;
+		for(int i = 0; i < n; i++) {
+			int l = 0;
+			for(int b = 0; b < nBlocks; b++) {
+				const int k = cnt[b][i];
+				cnt[b][i] = l;
+				l += k;
+			}
+			beg[i] = total;
+			len[i] = l;
+			total += l;
+		}
+
+		data.resize(m);
+		forBlocks(nBlocks, [&](int b) {
+			vector<int>& cntB = cnt[b];
+			for(int k = blockBegin(b); k < blockBegin(b+1); k++) {
+				const int i = key[k];
+				pos[k] = cntB[i]++;
+				data[beg[i] + pos[k]] = k;
+			}
+		});
+		cap = len;
+		nUsed = m;
+	}
+
+	// list lengths and elements of a compacted instance, whose lists are stored consecutively
+	const vector<int>& lengths() const  { return len; }
+	const vector<int>& elements() const { return data; }
+
+	// replaces all lists by n lists of the given lengths, whose elements are stored consecutively
+	void assignCompact(int n, const int* lengths, const int* elements)
+	{
+		len.assign(lengths, lengths+n);
+		cap = len;
+		beg.resize(n);
+		nUsed = 0;
+		for(int i = 0; i < n; i++) {
+			beg[i] = nUsed;
+			nUsed += len[i];
+		}
+		data.assign(elements, elements+nUsed);
+	}
+
+	void compact()
+	{
+		vector<int> d(nUsed);
+		int pos = 0;
+		for(int i = 0; i < size(); i++) {
+			copy_n(data.begin() + beg[i], len[i], d.begin() + pos);
+			beg[i] = pos;
+			cap[i] = len[i];
+			pos += len[i];
+		}
+		data.swap(d);
+	}
+
+private:
+	// runs f(b) for b = 0,...,nBlocks-1, all but the last one on separate threads
+	template<typename F>
+	static void forBlocks(int nBlocks, F f)
+	{
+		vector<thread> threads;
+		for(int b = 0; b < nBlocks-1; b++) {
+			threads.emplace_back(f, b);
+		}
+		f(nBlocks-1);
+		for(auto& t : threads) {
+			t.join();
+		}
+	}
+
+	void push(int i, int ij)
+	{
+		if(len[i] == cap[i]) relocate(i, max(4, 2*cap[i]));
+		data[beg[i] + len[i]++] = ij;
+		nUsed++;
+	}
+
+	void relocate(int i, int capacity)
+	{
+		// a list at the end of the array grows in place
+		if(beg[i] + cap[i] == (int)data.size()) {
+			data.resize(beg[i] + capacity);
+			cap[i] = capacity;
+			return;
+		}
+
+		if(data.size() > 1024 && (int)data.size() > 2*nUsed) {
+			compact();
+		}
+
+		const int b = (int)data.size();
+		data.resize(b + capacity);
+		copy_n(data.begin() + beg[i], len[i], data.begin() + b);
+		beg[i] = b;
+		cap[i] = capacity;
+	}
+
+	vector<int> data, beg, len, cap;
+	int nUsed = 0;
+};
+
 #endif // DS_H_
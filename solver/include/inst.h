@@ -22,9 +22,12 @@ public:
 
 	Inst();
 	Inst(const Inst& inst);
+	Inst(Inst&&) = default;
+	Inst& operator=(const Inst&) = default;
+	Inst& operator=(Inst&&) = default;
 	~Inst();
 
-	vector<vector<int>> din, dout;
+	Adjacency din, dout;
 	vector<int> tail, head;
 	vector<int> opposite;
 	 // position of arc in adjacency lists
@@ -45,6 +48,7 @@ public:
 	bool isMWCS = false;
 	Inst* inst1 = nullptr;
 	weight_t bigM = -1;
+	int arcMoves = 0; // number of arcs created or moved to other nodes, dual solutions do not carry over such changes
 
 	void resizeNodes(int _m);
 	void resizeEdges(int _m);
@@ -52,6 +56,9 @@ public:
 	void removeNode(int i);
 
 	void newArc(int i, int j, int ij, int ji, weight_t w);
+	// like newArc, but the adjacency lists are built for all arcs at once by buildAdjacency
+	void defineArc(int i, int j, int ij, int ji, weight_t w);
+	void buildAdjacency(int nArcs, int nThreads = 1);
 	void delArc(int ij);
 
 	void moveHead(int ij, int k);
@@ -94,4 +101,34 @@ public:
 	Transformation* transformation = nullptr;
 };
 
+// difference of an instance to the base instance it was derived from, i.e. the changes made by
+// fixings, reductions and cost changes. Used to store open branch-and-bound nodes compactly.
+class InstDiff {
+public:
+	InstDiff() {}
+	InstDiff(const Inst& base, const Inst& inst);
+
+	// turns a copy of the base instance into the instance
+	void apply(Inst& inst) const;
+
+	// changed lists, stored consecutively to avoid an allocation per list: list idx[k] consists of
+	// the elements beg[k],...,beg[k+1]-1 of data
+	struct ListEntries {
+		vector<int> idx, beg, data;
+	};
+
+private:
+	template<typename T> using Entries = vector<pair<int,T>>;
+
+	ListEntries din, dout, bmna, bmaa;
+	Entries<int> tail, head, opposite, pin, pout;
+	Entries<flag_t> f0, f1, fe0, T;
+	Entries<weight_t> c, p;
+	weight_t offset, bigM;
+	int t, r, arcMoves;
+
+	// written to and read from spill files
+	friend class NodeSpill;
+};
+
 #endif // INST_H_
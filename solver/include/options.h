@@ -20,11 +20,25 @@ public:
 		std::string file;
 		std::string solfile;
 		std::string boundsfile;
+		std::string presolvedfile;
+		std::string statefile;
+		std::string deltafile;
+		std::string resumefile;
+		std::string batchfile;
+		std::string servepath;
+		std::string portfolio;
+		bool        cache;
 		int         seed;
+		int         threads;
+		int         jobs;
 
 		// output
 		std::string soloutfile;
 		std::string statsfile;
+		std::string presolvedoutfile;
+		std::string stateoutfile;
+		std::string checkpointfile;
+		double      checkpointfreq;
 		bool printstatsline;
 
 		// problem type
@@ -34,6 +48,8 @@ public:
 		double timelimit;
 		int    nodelimit;
 		int    memlimit;
+		double spill;
+		std::string spilldir;
 
 		// branch-and-bound 
 		double cutoff;
@@ -45,6 +61,8 @@ public:
 		double daeager;
 		double dasat;
 		bool   daguide;
+		bool   dabucket;
+		bool   dasimd;
 
 		// heuristic
 		int    heurroots;
@@ -52,6 +70,8 @@ public:
 		bool   heurbb;
 		double heurbbtime;
 		double heureps;
+		int    heurasync;
+		int    heurqueue;
 
 		// enable/disable components
 		bool initprep;
@@ -67,8 +87,16 @@ public:
 		int  daiterations;
 		bool perturbedheur;
 		int  nodeselect;
+		double plungequot;
+		int  plungeopen;
 		int  branchtype;
+		int  relcands;
+		int  reliability;
+		int  probeiter;
 		bool lastcomp;
+		int  rootlookahead;
+		bool bbtrail;
+		bool bbwarmstart;
 
 		// reductions
 		bool d1;
@@ -84,8 +112,13 @@ public:
 	ProgramOptions(int &argc, char ** &argv);
 	virtual ~ProgramOptions();
 
+	// set if --help was given, helpText describes all options
+	bool help = false;
+	std::string helpText;
+
 };
 
-extern ProgramOptions::Parameters params;
+// parameters of the current solve, threads started by a ThreadGroup inherit them from their creator
+extern thread_local ProgramOptions::Parameters params;
 
 #endif /* OPTIONS_H_ */
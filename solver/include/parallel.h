@@ -0,0 +1,92 @@
+/**
+ * \file   parallel.h
+ * \brief  helpers for running solver components on multiple threads
+ *
+ * \author Martin Luipersbeck
+ * \date   2026-10-17
+ */
+
+#ifndef PARALLEL_H_
+#define PARALLEL_H_
+
+#include <thread>
+#include <vector>
+#include <deque>
+#include <exception>
+#include <mutex>
+
+#include "stats.h"
+#include "options.h"
+#include "timer.h"
+
+// group of threads, which inherit the parameters and the solve timer of the thread that starts them.
+// Statistics collected by the threads are merged into the statistics of the thread that calls join(),
+// which also rethrows the first exception thrown by one of the threads
+class ThreadGroup
+{
+public:
+	~ThreadGroup() { wait(); }
+
+	// runs f(i) on a new thread, where i is the index of the thread within the group
+	template<typename F>
+	void start(F f)
+	{
+		const int i = (int)threads.size();
+		wstats.emplace_back();
+		ProgramStats::Stats* s = &wstats.back();
+		const ProgramOptions::Parameters p = params;
+		const Timer* total = &Timer::total;
+		threads.push_back(std::thread([this, f, i, s, p, total]() {
+			params = p;
+			Timer::total.assign(*total);
+			try {
+				f(i);
+			} catch(...) {
+				std::lock_guard<std::mutex> lock(mtxError);
+				if(!error) error = std::current_exception();
+			}
+			*s = stats;
+		}));
+	}
+
+	void join()
+	{
+		wait();
+		if(error) {
+			std::exception_ptr e = error;
+			error = nullptr;
+			std::rethrow_exception(e);
+		}
+	}
+
+private:
+	std::vector<std::thread> threads;
+	std::deque<ProgramStats::Stats> wstats;
+	std::exception_ptr error;
+	std::mutex mtxError;
+
+	void wait()
+	{
+		for(auto& t : threads) {
+			t.join();
+		}
+		for(auto& s : wstats) {
+			ProgramStats::mergeStats(s);
+		}
+		threads.clear();
+		wstats.clear();
+	}
+};
+
+// runs f(i) for i = 0,...,nthreads-1 on separate threads and waits for all of them to finish
+template<typename F>
+void runThreads(int nthreads, F f)
+{
+	ThreadGroup group;
+	for(int i = 0; i < nthreads; i++) {
+		group.start([&f](int i) { f(i); });
+	}
+	group.join();
+}
+
+#endif // PARALLEL_H_
@@ -26,24 +26,22 @@ void BBTree::printBBLine(BBNode* b, NodeState state, bool bExit)
 	if(!bOutput || (nIter % params.bbinfofreq != 0 && !bExit && nIter != 1))
 		return;
 
-	weight_t prize = b->v == -1 ? -1 : b->inst->p[b->v];
-	if(prize >= WMAX) prize = -1;
-
+	// the instance of b may already be stored, use the tree instance for its properties
 	double outUB = ub;
 	double outLBNode = b->lb;
 	double outLB = bestlb;
-	if(b->inst->isMWCS) {
+	if(inst.isMWCS) {
 		outUB = inst.convertPCSTPBound2MWCS(outUB);
 		outLBNode = inst.convertPCSTPBound2MWCS(outLBNode);
 		outLB = inst.convertPCSTPBound2MWCS(outLB);
 	}
-	if(!b->inst->isInt) {
+	if(!inst.isInt) {
 		outUB /= params.precision;
 		outLB /= params.precision;
 		outLBNode /= params.precision;
 	}
 
-	printf("%7d %6d %6d %d", nIter, b->depth, (int)PQmin.size(), b->bdir);
+	printf("%7d %6d %6d %d", nIter, b->depth, openNodes(), b->bdir);
 
 	if(inst.isInt) printf("%13.0lf %13.0lf %13.0lf ", (double)outLBNode, (double)outLB, (double)outUB);
 	else           printf("%13.6lf %13.6lf %13.6lf ", (double)outLBNode, (double)outLB, (double)outUB);
@@ -82,6 +80,8 @@ void BBTree::printRootLine(BBNode* b)
 
 void BBTree::printHeurHeader()
 {
+	if(!bOutput) return;
+
 	printf("     ");
 	printf(" %15s", "sol");
 	if(bestKnown >= 0)
@@ -95,6 +95,8 @@ void BBTree::printHeurHeader()
 
 void BBTree::printHeurLine(int it, weight_t obj, bool bImproved, double time)
 {
+	if(!bOutput) return;
+
 	printf(" %c", bImproved ? '*' : ' ');
 	printf(" %2d:", (it+1));
 	printBoundPadded(inst, obj);
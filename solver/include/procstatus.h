@@ -12,6 +12,7 @@
 #include <iostream>
 #include <limits>
 #include <fstream>
+#include <atomic>
 
 using namespace std;
 
@@ -24,6 +25,7 @@ class ProcStatus
 private:
 
 	static u_int memlimit;
+	static atomic<int> solves;
 
 public:
 
@@ -34,8 +36,21 @@ public:
 
 	static void setMemLimit( u_int lim );
 	static u_int mem();
+	// resident set size in MB
+	static u_int resident();
 	static bool memOK();
 
+	// registers a solve for its lifetime: batch jobs and solves of the library (and thus of the
+	// daemon). The memory of the process is attributed to the registered solves in equal parts.
+	class SolveGuard
+	{
+	public:
+		SolveGuard()  { solves++; }
+		~SolveGuard() { solves--; }
+	};
+	// share of mb of each solve running concurrently
+	static u_int share(u_int mb);
+
 };
 
 #endif /* PROCSTATUS_H_ */
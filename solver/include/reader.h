@@ -0,0 +1,106 @@
+/**
+ * \file   reader.h
+ * \brief  line-based reader for instance files
+ *
+ * \author Martin Luipersbeck
+ * \date   2026-10-17
+ */
+
+#ifndef READER_H_
+#define READER_H_
+
+#include <vector>
+#include <cstddef>
+
+// read-only memory mapping of a file (or a buffer holding its content if it cannot be mapped)
+class MappedFile
+{
+public:
+	MappedFile(const char* fn);
+	~MappedFile();
+
+	bool        isOpen() const { return open; }
+	const char* data() const   { return begin; }
+	size_t      size() const   { return length; }
+
+private:
+	MappedFile(const MappedFile&);
+	MappedFile& operator=(const MappedFile&);
+
+	bool open = false, mapped = false;
+	const char* begin = nullptr;
+	size_t length = 0;
+	std::vector<char> buffer;
+};
+
+// reads the lines of a range of a file, usually a mapped file or a line-aligned chunk of it.
+// The patterns of a line are matched like the sscanf formats of the former loaders: literals
+// are compared exactly at the start of the line, numbers skip preceding whitespace.
+class LineReader
+{
+public:
+	LineReader(const char* begin, const char* end) : end(end), nextLine(begin) {}
+
+	// advances to the next line, returns false at the end of the file
+	bool next()
+	{
+		if(nextLine >= end) return false;
+		line = nextLine;
+		lineEnd = findLineEnd(line);
+		nextLine = (lineEnd == end) ? end : lineEnd+1;
+		pos = line;
+		return true;
+	}
+
+	// first character of the current line
+	char first() const { return *line; }
+
+	// matches s at the start of the line, e.g. match("E") followed by readInt() corresponds to "E %d"
+	bool match(const char* s)
+	{
+		pos = line;
+		for(; *s != '\0'; s++, pos++) {
+			if(pos == lineEnd || *pos != *s) return false;
+		}
+		return true;
+	}
+
+	// reads the next number like %d
+	bool readInt(int& v)
+	{
+		skipSpace();
+		const char* p = pos;
+		bool neg = false;
+		if(p != lineEnd && (*p == '-' || *p == '+')) {
+			neg = (*p == '-');
+			p++;
+		}
+		if(p == lineEnd || !isDigit(*p)) return false;
+		long x = 0;
+		for(; p != lineEnd && isDigit(*p); p++) {
+			x = 10*x + (*p - '0');
+		}
+		v = (int)(neg ? -x : x);
+		pos = p;
+		return true;
+	}
+
+	// reads the next number like %lf
+	bool readDouble(double& v);
+
+private:
+	const char *end = nullptr;
+	const char *line = nullptr, *lineEnd = nullptr, *nextLine = nullptr, *pos = nullptr;
+
+	static bool isDigit(char c) { return c >= '0' && c <= '9'; }
+	static bool isSpace(char c) { return c == ' ' || (c >= '\t' && c <= '\r'); }
+
+	void skipSpace()
+	{
+		while(pos != lineEnd && isSpace(*pos)) pos++;
+	}
+
+	const char* findLineEnd(const char* p) const;
+};
+
+#endif // READER_H_
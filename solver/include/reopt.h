@@ -0,0 +1,86 @@
+/**
+ * \file   reopt.h
+ * \brief  state of a solve reused to solve the instance again after changes of prizes and costs
+ *
+ * The state consists of the incumbent and of a partition of the search space of the preprocessed
+ * instance into regions, each given by its branching decisions (see BranchPath) and a lower bound
+ * valid for the region. When the instance is solved again, the incumbent is revalidated on the new
+ * weights. The bound of a region drops at most by the decrease of the weights its solutions may use,
+ * so regions that still cannot contain an improving solution remain closed and the others are
+ * reopened as open nodes. The incumbent is mapped to the preprocessed instance, or only bounds the
+ * search if preprocessing removed some of its arcs.
+ *
+ * Bounds refer to the instance reduced by the reduction tests of the root of a region. Bound-based
+ * reductions only remove solutions not better than the incumbent, which is accounted for by the bound
+ * of a region, but other reductions may remove solutions that become improving under the new weights.
+ * Hence, the regions of a root are only reused if its reductions yield the same instance up to its
+ * weights, and their bounds drop by the decrease of the weights of the root instance. Nodes below the
+ * roots are restricted to bound-based reductions while regions are recorded. If preprocessing yields
+ * the same instance, roots whose regions all remain closed are not processed again, otherwise all roots
+ * are processed again and the bound of the remaining region of a symmetric instance (solutions without
+ * any of the roots) is the sum of the prizes of the roots.
+ *
+ * Checkpoints of a running search (--checkpoint) are states whose regions are its open nodes, which
+ * are resumed without changes of weights (--resume). Regions replayed on the reduced root only lack
+ * the reductions of the nodes above them, so their bounds remain valid without restricting the
+ * reductions of the search.
+ *
+ * \author Martin Luipersbeck
+ * \date   2026-10-17
+ */
+
+#ifndef REOPT_H_
+#define REOPT_H_
+
+#include <map>
+#include <memory>
+#include <stdint.h>
+
+#include "def.h"
+#include "inst.h"
+#include "bbnode.h"
+
+// region of the search space, path lists the branching decisions (node, BranchPath::Kind) from the root
+struct ReoptRegion {
+	weight_t lb;
+	vector<pair<int,int>> path;
+};
+
+// root of the search, with the structure of its instance after the reduction tests and its duals.
+// The weights of its instance are given by their changes of the weights of the preprocessed instance.
+struct ReoptRoot {
+	uint64_t hash;
+	shared_ptr<const DualState> duals;
+	vector<pair<int,weight_t>> c, p;
+	weight_t offset = 0;
+};
+
+struct ReoptState {
+	// structure of the original instance and the incumbent on it
+	uint64_t instHash = 0;
+	vector<flag_t> solNodes, solArcs;
+	int solRoot = -1;
+
+	// structure and weights of the preprocessed instance searched by the regions
+	uint64_t prepHash = 0;
+	vector<weight_t> prepC, prepP;
+	weight_t prepOffset = 0;
+
+	// regions are only reusable if they cover the search space (all roots have been processed)
+	bool complete = false;
+	vector<ReoptRegion> regions;
+	map<int, ReoptRoot> roots;
+
+	// branching priorities of the search, only written by checkpoints
+	vector<int> prio;
+};
+
+// hash of the graph of an instance and its fixings, independent of prizes and costs
+uint64_t structureHash(const Inst& inst);
+
+// applies the changes of a delta file to the prizes and costs of a loaded instance. Lines are
+// E <i> <j> <cost> (cost of the edge or arcs between i and j) and TP <i> <prize> (pcstp only).
+// Returns the number of changes.
+int  applyDelta(Inst& inst, const char* fn);
+
+#endif // REOPT_H_
@@ -0,0 +1,16 @@
+/**
+ * \file   server.h
+ * \brief  solver daemon on a unix domain socket
+ *
+ * \author Martin Luipersbeck
+ * \date   2026-10-17
+ */
+
+#ifndef SERVER_H_
+#define SERVER_H_
+
+// serves solve requests on the unix domain socket at path with --jobs worker threads until the
+// process is terminated. The options argv[1],...,argv[argc-1] are the defaults of every request.
+void serve(const char* path, int argc, char* argv[]);
+
+#endif // SERVER_H_
@@ -0,0 +1,52 @@
+/**
+ * \file   spill.h
+ * \brief  temporary file holding open B&B nodes moved out of memory
+ *
+ * Once the resident memory exceeds --bb.spill times the memory limit, the open nodes selected last
+ * are spilled: the difference of their instance to the base instance of their subtree and their
+ * duals are written to the file and read back when the node is selected. Bound, branching decisions
+ * and base instance stay in memory, so only stored nodes (see --bb.trail) are spilled.
+ *
+ * The file is created when the first node is spilled. If it cannot be created, a warning is printed
+ * and spilling is disabled. Records are appended and never reused, the file is removed when it is closed. Writes reserve their
+ * range under a lock and reads are positional, so the file is shared by the workers of a search.
+ *
+ * \author Martin Luipersbeck
+ * \date   2026-10-17
+ */
+
+#ifndef SPILL_H_
+#define SPILL_H_
+
+#include <mutex>
+#include <atomic>
+#include <stdint.h>
+
+#include "bbnode.h"
+
+class NodeSpill
+{
+public:
+	// the file is created in directory dir (empty: the system temporary directory)
+	explicit NodeSpill(const string& dir);
+	~NodeSpill();
+
+	// creates the file on first use, returns false if it could not be created
+	bool     open();
+
+	// moves the difference and the duals of a stored node to the file, returns false if it has none
+	bool     spill(BBNode* b);
+	// reads them back, if the node is spilled
+	void     unspill(BBNode* b);
+
+	int64_t  size() const { return end; }
+
+private:
+	string dir;
+	int fd = -1;
+	bool failed = false;
+	mutex mtx;
+	atomic<int64_t> end{0};
+};
+
+#endif // SPILL_H_
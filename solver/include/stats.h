@@ -27,6 +27,18 @@ public:
 
 		// heur
 		double heurtime = 0.0, heurbbtime = 0.0;
+		// asynchronous node heuristic: queued and dropped support graphs, maximum queue length, improvements
+		int heurjobs = 0, heurdrops = 0, heurqueue = 0, heurimproved = 0;
+
+		// portfolio: configuration that proved optimality first (-1: none)
+		int portfolio = -1;
+
+		// open nodes moved to the spill file and read back, maximum size of the file in MB
+		int spilled = 0, unspilled = 0;
+		double spillmb = 0.0;
+
+		// dual ascent probes of reliability branching
+		int probes = 0;
 
 		// root data
 		double rootlb = 0.0, rootub = -1, rootgap = 100.0;
@@ -50,12 +62,16 @@ public:
 		bool valid = false;
 	};
 
+	// row of the statistics file for the current solve (terminated by a newline)
+	static string statsLine();
 	static void writeStats(const char* file);
 	static void initRootNodeStats();
 	static void addRootNodeStats(InstSizeData& sdata);
 	static void averageRootNodeStats(int nRootsOpen);
+	static void mergeStats(const Stats& s);
 
 };
-extern ProgramStats::Stats stats;
+// each thread collects its own statistics, worker threads merge their counters on join
+extern thread_local ProgramStats::Stats stats;
 
 #endif // STATS_H_
@@ -31,7 +31,11 @@ public:
 
 	void resume();
 
-	const static Timer total;
+	// continues the time measurement of t, e.g. on another thread
+	void assign(const Timer& t);
+
+	// time since the start of the current solve
+	static thread_local Timer total;
 
 private:
 	std::mutex atomic;
@@ -13,9 +13,21 @@
 #include "sol.h"
 
 Inst load(const char* fn);
-Inst loadPCSTP(const char* fn);
-Inst loadNWSTP(const char* fn);
-Inst loadMWCS(const char* fn);
+// loads an instance from the content of an instance file of type params.type
+Inst loadText(const char* begin, const char* end);
+// loads an instance from the content of an instance file or a binary cache file
+Inst loadData(const char* data, size_t size);
+Inst loadPCSTP(const char* begin, const char* end);
+Inst loadNWSTP(const char* begin, const char* end);
+Inst loadMWCS(const char* begin, const char* end);
+// computes the terminals and anti-parallel arcs of an instance whose arcs and prizes are defined
+void finalizeInst(Inst& inst);
+double bidirectRatio(Inst& inst);
+
+// random numbers like srand()/rand(), but with a separate state per thread (seeded with --seed
+// unless seedRandom is called), so concurrent solves do not influence each other
+void seedRandom(unsigned seed);
+int  randomInt();
 
 double getBestKnownBound(const char* fn, const char* boundfile);
 void   printBound(Inst& inst, weight_t bound);
@@ -25,11 +37,25 @@ double format(weight_t bound, Inst& inst);
 void recoverPartialSol(Sol& sol, Inst& inst1);
 int  cntReachable(int r, Sol& sol, Inst& inst);
 Sol  genPartialSol(Sol& sol, Inst& inst);
+// genPartialSol in two steps: the arcs of the original instance used by a solution on a reduced
+// instance (and the candidates for its root) are collected while the reduced instance exists,
+// the partial solution is built from them later
+struct SolSupport
+{
+	weight_t obj = WMAX;
+	vector<int> arcs, nodes, roots;
+};
+SolSupport collectSolSupport(Sol& sol, Inst& inst);
+Sol  expandSolSupport(const SolSupport& s, Inst& inst1);
+// maps a solution of the original instance to the reduced instance inst, by the arcs of inst whose
+// original arcs (or their opposites, if symmetric) are all part of it. Returns false if the mapped
+// arcs do not yield a feasible solution.
+bool mapSolution(const Sol& sol1, Inst& inst, Sol& sol);
 Inst genInst(Sol& sol, Inst& inst1, vector<int>& amap, vector<int>& nmap);
 
-void enlargeStack();
-
 void writeSolution(const char* file, Inst& inst, Sol& sol);
+// content of the solution file written by writeSolution
+string solutionText(Inst& inst, Sol& sol);
 
 Sol loadSol(const char* fn, Inst& inst);
 
@@ -8,6 +8,11 @@
 
 #include "bbnode.h"
 
+// instance released by the last node stored on this thread. It is reused by the next restore, whose
+// copy of the base instance then overwrites arrays and backmapping lists in place instead of
+// allocating them again.
+static thread_local unique_ptr<Inst> spare;
+
 BBNode::BBNode(Inst* inst) {
 	v = -1;
 	bdir = -1;
@@ -41,6 +46,18 @@ BBNode::BBNode(const BBNode* b, int var, int bdir) : inst(b->inst), bdir(bdir) {
 	n = b->n;
 	m = b->m;
 	processed = false;
+	duals = b->duals;
+	if(b->path != nullptr)
+		path = BranchPath::extend(b->path, var, bdir == 0 ? BranchPath::OUT : BranchPath::IN);
+
+	if(b->inst == nullptr || b->kept) {
+		// stored parent, the instance is shared until the node is restored
+		inst = nullptr;
+		base = b->base;
+		diff = b->diff;
+		pending = true;
+		return;
+	}
 
 	if(bdir == 0) {
 		inst = new Inst(*b->inst);
@@ -53,6 +70,77 @@ BBNode::BBNode(const BBNode* b, int var, int bdir) : inst(b->inst), bdir(bdir) {
 		inst->T[v] = true;
 	}
 }
+
+void BBNode::applyBranch()
+{
+	if(inst == nullptr) {
+		pending = true;
+		return;
+	}
+
+	if(bdir == 0) {
+		inst->removeNode(v);
+	} else if(bdir == 1) {
+		inst->f1[v] = true;
+		inst->T[v] = true;
+		inst->p[v] = WMAX;
+	}
+}
+
+void BBNode::store()
+{
+	if(inst == nullptr)
+		return;
+
+	if(kept) {
+		// the decision applied to the kept instance is applied again when it is restored
+		delete inst;
+		inst = nullptr;
+		kept = false;
+		pending = true;
+		return;
+	}
+
+	// the first stored node of a subtree provides the base instance
+	if(base == nullptr) {
+		base.reset(inst);
+	} else {
+		diff = make_shared<const InstDiff>(*base, *inst);
+		spare.reset(inst);
+	}
+	inst = nullptr;
+}
+
+void BBNode::keep()
+{
+	if(base == nullptr) {
+		base = make_shared<const Inst>(*inst);
+		diff = nullptr;
+	} else {
+		diff = make_shared<const InstDiff>(*base, *inst);
+	}
+	kept = true;
+}
+
+void BBNode::restore()
+{
+	if(inst != nullptr)
+		return;
+
+	if(spare != nullptr) {
+		inst = spare.release();
+		*inst = *base;
+	} else {
+		inst = new Inst(*base);
+	}
+	if(diff != nullptr)
+		diff->apply(*inst);
+
+	if(pending) {
+		pending = false;
+		applyBranch();
+	}
+}
 void BBNode::updateNodeSize()
 {
 	n = 0;
@@ -17,9 +17,28 @@
 #include "options.h"
 #include "timer.h"
 #include "procstatus.h"
+#include "parallel.h"
+#include "cache.h"
 
 #include <stack>
 #include <map>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+
+// number of B&B iterations between checks of the memory usage for spilling open nodes
+static const int spillCheckFreq = 64;
+
+// decisions of a path from the root, as (node, BranchPath::Kind)
+static vector<pair<int,int>> pathSteps(const shared_ptr<const BranchPath>& path)
+{
+	vector<pair<int,int>> steps;
+	for(const BranchPath* p = path.get(); p != nullptr; p = p->parent.get()) {
+		steps.push_back(make_pair(p->v, (int)p->kind));
+	}
+	reverse(steps.begin(), steps.end());
+	return steps;
+}
 
 BBTree::BBTree(Inst& inst) : inst(inst), inc(inst), inst1(inst), inc1(inst1)
 {
@@ -35,6 +54,10 @@ BBTree::BBTree(Inst& inst) : inst(inst), inc(inst), inst1(inst), inc1(inst1)
 	timeLim = DMAX;
 	
 	prio.resize(inst.n, 0);
+	for(int d = 0; d < 2; d++) {
+		pcSum[d].resize(inst.n, 0.0);
+		pcCnt[d].resize(inst.n, 0);
+	}
 
 	rndGen = mt19937(params.seed);
 
@@ -45,6 +68,7 @@ BBTree::BBTree(Inst& inst) : inst(inst), inc(inst), inst1(inst), inc1(inst1)
 	for(int ij = 0; ij < inst.m; ij++) inst.bmaa[ij].push_back(ij);
 
 	inst.inst1 = &inst1;
+	board = make_shared<BoundBoard>(inst1);
 
 	cr.resize(inst.m, 0);
 	pi.resize(inst.n, 0);
@@ -87,6 +111,57 @@ BBTree::BBTree(Inst& inst) : inst(inst), inc(inst), inst1(inst), inc1(inst1)
 	}
 }
 
+BBTree::BBTree(BBTree& master, Inst& inst, int id) : inst(inst), inc(inst), inc1(inst1)
+{
+	this->master = &master;
+	board = master.board;
+
+	lbM = master.lbM;
+	bestlb = master.bestlb;
+	rootlb = master.rootlb;
+	rootub = master.rootub;
+	ub = master.ub;
+	tState = BB_NONE;
+
+	solLim = master.solLim;
+	nodeLim = master.nodeLim;
+	timeLim = master.timeLim;
+	cancel = master.cancel;
+	portfolio = master.portfolio;
+
+	bRecover = master.bRecover;
+	bOutput = false;
+	processedRoots = true;
+
+	nImprovements = 0;
+	nIter = 0;
+	bestSingleNodeSolObj = WMAX;
+	bestSingleNodeSolNode = -1;
+
+	prio = master.prio;
+	for(int d = 0; d < 2; d++) {
+		pcSum[d] = master.pcSum[d];
+		pcCnt[d] = master.pcCnt[d];
+	}
+
+	rndGen = mt19937(params.seed + id + 1);
+
+	cr.resize(inst.m, 0);
+	pi.resize(inst.n, 0);
+	crf.resize(inst.m, 0);
+	pif.resize(inst.n, 0);
+
+	// guiding solutions are reoriented by each worker, so every worker needs its own copies
+	for(auto S : master.pool) {
+		Sol* S1 = new Sol(inst);
+		*S1 = *S;
+		pool.push_back(S1);
+	}
+
+	incVersion = -1;
+	syncIncumbent();
+}
+
 BBTree::~BBTree()
 {
 	for(auto S : pool)
@@ -95,47 +170,113 @@ BBTree::~BBTree()
 
 bool BBTree::updatePrimal(Inst& inst, Sol& sol)
 {
-	if(sol.obj < ub) {
-		// validate solution before acceptance
-		const bool bValid = sol.validate();
-		if(!bValid) {
-			printf("WARNING: obtained solution infeasible, discarding.\n");
-			return false;
-		}
-		nImprovements++;
-		inc.update(sol);
+	const bool bImproved = publishPrimal(inst, sol);
+	syncIncumbent();
+	return bImproved;
+}
 
-		// if in recovery mode, store solution as partial solution on the unpreprocessed inst1
-		if(!bRecover) {
-			inc1 = genPartialSol(inc, inst);
-			timeBestSol = Timer::total.elapsed().getSeconds();
-		}
+bool BBTree::publishPrimal(Inst& inst, Sol& sol)
+{
+	if(sol.obj >= board->ub())
+		return false;
+
+	// validate solution before acceptance
+	const bool bValid = sol.validate();
+	if(!bValid) {
+		printf("WARNING: obtained solution infeasible, discarding.\n");
+		return false;
+	}
 
-		ub = sol.obj;
+	// if in recovery mode, the solution is not mapped to the unpreprocessed inst1
+	const BoundBoard::Incumbent* S = board->publish(sol, inst, !bRecover);
+	if(S == nullptr)
+		return false;
 
-		return true;
+	if(portfolio != nullptr)
+		atomicMin(portfolio->ub, S->sol.obj);
+
+	BBTree& top = (master != nullptr) ? *master : *this;
+	top.nImprovements++;
+	if(top.incumbentCallback) {
+		lock_guard<mutex> lock(top.mtxCallback);
+		if(board->incumbent() == S)
+			top.incumbentCallback(S->sol.obj);
 	}
+	return true;
+}
 
-	return false;
+void BBTree::setIncumbent(Sol& sol)
+{
+	// before preprocessing, the backmapping is the identity
+	board->reset(sol, inst);
+	syncIncumbent();
+}
+
+void BBTree::syncIncumbent()
+{
+	// the upper bound of other portfolio members is a cutoff
+	if(portfolio != nullptr && portfolio->ub.load(memory_order_relaxed) < board->ub())
+		board->cutUp(portfolio->ub);
+
+	// the bound and the version are atomics, so the lock is only taken if the incumbent changed
+	const weight_t b = board->ub();
+	if(b == ub && board->version() == incVersion)
+		return;
+
+	const BoundBoard::Incumbent* S = board->incumbent();
+	lock_guard<mutex> lock(mtxInc);
+	ub = b;
+	if(S != nullptr && S->version != incVersion) {
+		inc = S->sol;
+		incVersion = S->version;
+	}
+}
+
+void BBTree::importPortfolioBounds()
+{
+	if(portfolio == nullptr)
+		return;
+	syncIncumbent();
+	bestlb = max(bestlb, min(portfolio->lb.load(), ub));
+	if(bestlb >= ub)
+		tState = BB_OPTIMAL;
+}
+
+void BBTree::syncOriginal()
+{
+	if(board->version() == inc1Version)
+		return;
+	inc1 = board->original(inc1Version);
+}
+
+double BBTree::getTimeBest()
+{
+	const BoundBoard::Incumbent* S = board->incumbent();
+	return (S != nullptr) ? S->time : 0.0;
 }
 
 weight_t BBTree::perturbedPrimalHeur(Inst& inst)
+{
+	Sol sol = perturbedSol(inst, inc, crf, pif, ub);
+	updatePrimal(inst, sol);
+	
+	return sol.obj;
+}
+
+Sol BBTree::perturbedSol(Inst& inst, Sol& guide, vector<double>& crf, vector<double>& pif, weight_t ub)
 {
 	// compute perturbed cost
 	vector<double> c1(inst.m);
 	for (int i = 0; i < inst.m; i++) {
-		const double eps = inc.arcs[i] ? -params.heureps : params.heureps;
+		const double eps = guide.arcs[i] ? -params.heureps : params.heureps;
 		c1[i] = max(0.0, inst.c[i]*(1+eps));
 	}
 
-	daR(inst.r, inst, c1, crf, pif, ub, params.daeager, &inc, true);
+	daR(inst.r, inst, c1, crf, pif, ub, params.daeager, &guide, true);
 
 	// apply primI to support graph
 	auto c2 = setSupportGraphf(inst, crf);
-	Sol sol = primI(inst.r, inst, c2);
-	updatePrimal(inst, sol);
-	
-	return sol.obj;
+	return primI(inst.r, inst, c2);
 }
 
 void BBTree::initHeur()
@@ -245,7 +386,7 @@ void BBTree::initHeur()
 		}
 
 		if(++iter == params.heurroots) break;
-		if(ub - lbM <= params.absgap) {
+		if(ub - lbM <= params.absgap || cancelled()) {
 			break;
 		}
 	}
@@ -282,7 +423,7 @@ void BBTree::initHeur()
 			fe0.push_back(ij);
 		}
 		// choose root at random from the set of initial heuristic iterations
-		int rndroot = rand()%min(params.heurroots,(int)roots.size());
+		int rndroot = randomInt()%min(params.heurroots,(int)roots.size());
 		int r = roots[rndroot];
 		makeRoot(r, 0.1, fe0);
 		
@@ -311,6 +452,169 @@ void BBTree::initHeur()
 	bHeur = false;
 }
 
+// Roots of symmetric instances are processed on an instance in which all previously processed roots
+// are forbidden. Workers evaluate the dual ascent for upcoming roots ahead of time by forbidding the
+// earlier roots on their own copies of the instance. Since the dual ascent is guided by the incumbent,
+// a result is only used if the incumbent did not change since the worker took its copy, otherwise the
+// root is evaluated again. Hence, the outcome is identical to the sequential processing of the roots.
+class BBTree::RootSpeculation
+{
+public:
+	RootSpeculation(BBTree& bb, vector<int>& roots);
+	~RootSpeculation();
+
+	// master side, called in the order of the roots
+	void rootSolution(int idx);
+	bool result(int idx, weight_t& lb);
+	void advance(int idx);
+
+private:
+	enum SlotState { SLOT_OPEN, SLOT_RUNNING, SLOT_DONE };
+
+	struct Worker
+	{
+		Worker(const Inst& inst) : inst(inst), inc(this->inst), cr(inst.m), pi(inst.n) {}
+
+		Inst inst;
+		Sol inc;
+		vector<weight_t> cr, pi;
+		vector<int> fe0;
+		weight_t ub = WMAX;
+		int nFixed = 0;      // number of leading roots forbidden on inst
+		int incRoot = -1;    // index of the last root inc has been rooted at
+		int incVersion = -1;
+	};
+
+	void work(Worker& w);
+
+	BBTree& bb;
+	vector<int>& roots;
+	int lookahead;
+	vector<unique_ptr<Worker>> workers;
+	ThreadGroup threads;
+
+	mutex mtx;
+	condition_variable cv;
+	int  cur = 0, next = 1;
+	bool finished = false;
+	vector<int> state, version;
+	vector<weight_t> lbs;
+
+	// index of the last root the incumbent of the master has been rooted at (guarded by bb.mtxInc)
+	int incRoot = -1;
+};
+
+BBTree::RootSpeculation::RootSpeculation(BBTree& bb, vector<int>& roots) :
+		bb(bb), roots(roots), state(roots.size(), SLOT_OPEN), version(roots.size(), -1), lbs(roots.size(), 0)
+{
+	lookahead = (params.rootlookahead > 0) ? params.rootlookahead : 2*params.threads;
+
+	// instance copies are made before any worker starts, as the master modifies its instance afterwards
+	const int nWorkers = max(1, params.threads-1);
+	for(int i = 0; i < nWorkers; i++) {
+		workers.emplace_back(new Worker(bb.inst));
+	}
+	for(int i = 0; i < nWorkers; i++) {
+		threads.start([this](int id) { work(*workers[id]); });
+	}
+}
+
+BBTree::RootSpeculation::~RootSpeculation()
+{
+	{
+		lock_guard<mutex> lock(mtx);
+		finished = true;
+	}
+	cv.notify_all();
+	threads.join();
+}
+
+void BBTree::RootSpeculation::rootSolution(int idx)
+{
+	lock_guard<mutex> lock(bb.mtxInc);
+	bb.inc.rootSolution(roots[idx]);
+	incRoot = idx;
+}
+
+bool BBTree::RootSpeculation::result(int idx, weight_t& lb)
+{
+	unique_lock<mutex> lock(mtx);
+	while(state[idx] == SLOT_RUNNING) {
+		cv.wait(lock);
+	}
+
+	// incVersion is only modified by the master thread
+	if(state[idx] == SLOT_DONE && version[idx] == bb.incVersion) {
+		lb = lbs[idx];
+		return true;
+	}
+	return false;
+}
+
+void BBTree::RootSpeculation::advance(int idx)
+{
+	{
+		lock_guard<mutex> lock(mtx);
+		cur = idx+1;
+	}
+	cv.notify_all();
+}
+
+void BBTree::RootSpeculation::work(Worker& w)
+{
+	const int nRoots = (int)roots.size();
+
+	unique_lock<mutex> lock(mtx);
+	while(!finished) {
+		next = max(next, cur+1);
+		if(next >= nRoots) break;
+		if(next > cur+lookahead) {
+			cv.wait(lock);
+			continue;
+		}
+		const int j = next++;
+		state[j] = SLOT_RUNNING;
+		lock.unlock();
+
+		// forbid all roots preceding j
+		for(; w.nFixed < j; w.nFixed++) {
+			bb.fixTerm(w.inst, roots[w.nFixed], w.fe0);
+		}
+		w.fe0.clear();
+
+		// reproduce the incumbent used by the master for root j, unless the master already passed it
+		bool bPassed;
+		{
+			lock_guard<mutex> lockInc(bb.mtxInc);
+			bPassed = (incRoot > j);
+			if(!bPassed && w.incVersion != bb.incVersion) {
+				w.inc = bb.inc;
+				w.ub = bb.ub;
+				w.incVersion = bb.incVersion;
+				w.incRoot = incRoot;
+			}
+		}
+
+		weight_t lb = 0;
+		if(!bPassed) {
+			for(; w.incRoot < j; w.incRoot++) {
+				w.inc.rootSolution(roots[w.incRoot+1]);
+			}
+
+			const int k = roots[j];
+			w.inst.f1[k] = true;
+			w.inst.T[k] = true;
+			lb = daR(k, w.inst, w.inst.c, w.cr, w.pi, w.ub, params.daeager, &w.inc);
+		}
+
+		lock.lock();
+		lbs[j] = lb;
+		version[j] = w.incVersion;
+		state[j] = bPassed ? SLOT_OPEN : SLOT_DONE;
+		cv.notify_all();
+	}
+}
+
 void BBTree::processRoots()
 {
 	Timer tRoot(true);
@@ -325,26 +629,55 @@ void BBTree::processRoots()
 		ProgramStats::initRootNodeStats();
 	}
 
+	recordPrep();
 	printRootHeader();
 	vector<int> roots = sortedListPotentialRoots();
 	vector<int> fe0;
 	int processed = 0;
+
+	// regions of symmetric instances exclude the roots processed before, the remaining region
+	// consists of the solutions without any of them (empty once a fixed node is excluded)
+	shared_ptr<const BranchPath> excluded;
+	bool bRestEmpty = false;
+	int covered = 0;
 	
 	tState = BB_NONE;
-	for(int k : roots) {
+	// roots of symmetric instances are evaluated ahead by worker threads, skipping roots
+	// by their semi-big-M bound would change the forbidden roots and is not supported
+	RootSpeculation* spec = nullptr;
+	if(!inst.isAsym && params.threads > 1 && roots.size() > 1 && !params.semiBigM) {
+		spec = new RootSpeculation(*this, roots);
+	}
+
+	// roots of asymmetric instances are independent of each other
+	if(inst.isAsym && params.threads > 1 && roots.size() > 1) {
+		processed = processRootsParallel(roots, tRoot, covered);
+	} else
+	for(int idx = 0; idx < (int)roots.size(); idx++) {
+		const int k = roots[idx];
+		auto path = bPaths ? BranchPath::extend(excluded, k, BranchPath::ROOT) : nullptr;
 		if(params.semiBigM && inst.r == -1 && lbM > 0 && lbM + crM[inst.m+k] >= ub) {
+			closeRegion(path, lbM + crM[inst.m+k]);
+			covered++;
 			continue;
 		}
 
 		inst.f1[k] = true;
 		inst.T[k] = true;
-		inc.rootSolution(k);
-		
-		weight_t lb = daR(k, inst, inst.c, cr, pi, ub, params.daeager, &inc);
+
+		weight_t lb;
+		if(spec != nullptr) {
+			spec->rootSolution(idx);
+			if(!spec->result(idx, lb))
+				lb = daR(k, inst, inst.c, cr, pi, ub, params.daeager, &inc);
+		} else {
+			inc.rootSolution(k);
+			lb = daR(k, inst, inst.c, cr, pi, ub, params.daeager, &inc);
+		}
 		
 		if(ub - lb > params.absgap) {
 
-			BBNode* b = makeRoot(k, lb, fe0);
+			BBNode* b = makeRoot(k, lb, fe0, path);
 			
 			if(b != nullptr) {
 				InstSizeData sdata = b->inst->countInstSize();
@@ -354,23 +687,32 @@ void BBTree::processRoots()
 
 				printRootLine(b);
 			}
+		} else {
+			closeRegion(path, lb);
 		}
 		
 		if(!inst.isAsym) {
+			bRestEmpty |= f1[k];
 			fixTerm(inst, k, fe0);
+			if(bPaths)
+				excluded = BranchPath::extend(excluded, k, BranchPath::EXCLUDE);
 		} else {
 			inst.f1[k] = f1[k];
 			inst.T[k] = T[k];
 		}
 		processed++;
+		covered++;
+		if(spec != nullptr) {
+			spec->advance(idx);
+		}
 
-		if(ProcStatus::mem() > params.memlimit || tState == BB_MEMLIMIT) {
+		if(memUsed() > memLimit() || tState == BB_MEMLIMIT) {
 			tState = BB_MEMLIMIT;
 			if(bOutput)
 				printf(" --- out of memory during root node processing\n");
 			break;
 		}
-		if(tRoot.elapsed().getSeconds() > timeLim ) {
+		if(timeUp(tRoot)) {
 			tState = BB_TIMELIMIT;
 			if(bOutput)
 				printf(" --- reached time limit during root node processing\n");
@@ -378,6 +720,14 @@ void BBTree::processRoots()
 		}
 		if(inst.offset >= ub) break;
 	}
+	delete spec;
+
+	if(!inst.isAsym) {
+		closeRegion(excluded, bRestEmpty ? ub : inst.offset);
+		bRootsComplete = (excluded != nullptr);
+	} else {
+		bRootsComplete = (covered == (int)roots.size());
+	}
 	
 	inst.c = c;
 	inst.T = T;
@@ -420,15 +770,537 @@ void BBTree::processRoots()
 	printRootSummary();
 }
 
+int BBTree::processRootsParallel(vector<int>& roots, Timer& tRoot, int& covered)
+{
+	const int nRoots = (int)roots.size();
+	vector<BBNode*> nodes(nRoots, nullptr);
+	vector<flag_t> done(nRoots, false);
+	atomic<int> next(0), state((int)BB_NONE), nSkipped(0);
+
+	// each worker evaluates roots on its own copy of the instance
+	runThreads(min(params.threads, nRoots), [&](int id) {
+		Inst winst(inst);
+		BBTree w(*this, winst, id);
+		vector<int> fe0;
+
+		int idx;
+		while(state == BB_NONE && (idx = next++) < nRoots) {
+			const int k = roots[idx];
+
+			w.syncIncumbent();
+			auto path = bPaths ? BranchPath::extend(nullptr, k, BranchPath::ROOT) : nullptr;
+			if(params.semiBigM && inst.r == -1 && lbM > 0 && lbM + crM[inst.m+k] >= w.ub) {
+				w.closeRegion(path, lbM + crM[inst.m+k]);
+				nSkipped++;
+				continue;
+			}
+
+			winst.f1[k] = true;
+			winst.T[k] = true;
+			w.inc.rootSolution(k);
+
+			weight_t lb = daR(k, winst, winst.c, w.cr, w.pi, w.ub, params.daeager, &w.inc, false, false, board->liveUB());
+			w.syncIncumbent();
+
+			if(w.ub - lb > params.absgap) {
+				nodes[idx] = w.makeRoot(k, lb, fe0, path);
+			} else {
+				w.closeRegion(path, lb);
+			}
+
+			winst.f1[k] = inst.f1[k];
+			winst.T[k] = inst.T[k];
+			done[idx] = true;
+
+			if(memUsed() > memLimit()) {
+				state = BB_MEMLIMIT;
+			} else if(timeUp(tRoot)) {
+				state = BB_TIMELIMIT;
+			}
+		}
+
+		// open nodes are handed over to this tree below
+		w.PQmax.clear();
+		w.PQmin.clear();
+	});
+	syncIncumbent();
+	board->reclaim();
+
+	// add open nodes in the order of roots, such that node selection does not depend on thread timing
+	int processed = 0;
+	for(int idx = 0; idx < nRoots; idx++) {
+		if(!done[idx]) continue;
+		processed++;
+
+		BBNode* b = nodes[idx];
+		if(b == nullptr) continue;
+
+		InstSizeData sdata = b->inst->countInstSize();
+		if(!bRecover) {
+			ProgramStats::addRootNodeStats(sdata);
+		}
+		printRootLine(b);
+
+		if(b->state == BB_BRANCH) {
+			add(b);
+		} else {
+			delete b->inst;
+			delete b;
+		}
+	}
+
+	covered = processed + nSkipped;
+	tState = (State)state.load();
+	if(bOutput) {
+		if(tState == BB_MEMLIMIT)
+			printf(" --- out of memory during root node processing\n");
+		if(tState == BB_TIMELIMIT)
+			printf(" --- reached time limit during root node processing\n");
+	}
+
+	return processed;
+}
+
+// Primal heuristic of the B&B nodes on separate threads. Nodes queue a copy of their instance, with
+// the support graph of their dual ascent unless the heuristic perturbs the costs, which is then done
+// on the heuristic thread. Improving solutions are published on the board, from which the trees pick
+// them up. Nodes never wait for the queue, their instance is not queued while it is full.
+class BBTree::AsyncHeur
+{
+public:
+	AsyncHeur(BBTree& bb);
+	~AsyncHeur();
+
+	// c is the support graph, or empty for the perturbed heuristic
+	void submit(Inst& inst, vector<weight_t> c);
+
+private:
+	struct Job
+	{
+		unique_ptr<Inst> inst;
+		vector<weight_t> c;
+	};
+
+	void work();
+
+	BBTree& bb;
+	size_t capacity;
+	ThreadGroup threads;
+
+	mutex mtx;
+	condition_variable cv;
+	deque<Job> jobs;
+	bool finished = false;
+	int nJobs = 0, nDropped = 0, maxQueue = 0;
+	atomic<int> nImproved{0};
+};
+
+BBTree::AsyncHeur::AsyncHeur(BBTree& bb) : bb(bb)
+{
+	capacity = (params.heurqueue > 0) ? params.heurqueue : 2*params.heurasync;
+	for(int i = 0; i < params.heurasync; i++) {
+		threads.start([this](int) { work(); });
+	}
+}
+
+BBTree::AsyncHeur::~AsyncHeur()
+{
+	// queued instances are discarded
+	{
+		lock_guard<mutex> lock(mtx);
+		finished = true;
+		nDropped += (int)jobs.size();
+		jobs.clear();
+	}
+	cv.notify_all();
+	threads.join();
+
+	stats.heurjobs += nJobs;
+	stats.heurdrops += nDropped;
+	stats.heurqueue = max(stats.heurqueue, maxQueue);
+	stats.heurimproved += nImproved;
+}
+
+void BBTree::AsyncHeur::submit(Inst& inst, vector<weight_t> c)
+{
+	{
+		lock_guard<mutex> lock(mtx);
+		if(jobs.size() >= capacity) {
+			nDropped++;
+			return;
+		}
+	}
+
+	// the instance is copied outside of the lock, so the queue may be full again afterwards
+	Job job;
+	job.inst.reset(new Inst(inst));
+	job.c = std::move(c);
+
+	lock_guard<mutex> lock(mtx);
+	if(jobs.size() >= capacity) {
+		nDropped++;
+		return;
+	}
+	jobs.push_back(std::move(job));
+	nJobs++;
+	maxQueue = max(maxQueue, (int)jobs.size());
+	cv.notify_one();
+}
+
+void BBTree::AsyncHeur::work()
+{
+	vector<double> crf, pif;
+
+	unique_lock<mutex> lock(mtx);
+	for(;;) {
+		cv.wait(lock, [this]() { return finished || !jobs.empty(); });
+		if(finished) break;
+		Job job = std::move(jobs.front());
+		jobs.pop_front();
+		lock.unlock();
+
+		Inst& inst = *job.inst;
+		if(job.c.empty()) {
+			// the board keeps the incumbent alive while the heuristic threads run
+			Sol guide(inst);
+			const BoundBoard::Incumbent* S = bb.board->incumbent();
+			if(S != nullptr)
+				guide.arcs = S->sol.arcs;
+			crf.resize(inst.m);
+			pif.resize(inst.n);
+			Sol sol = bb.perturbedSol(inst, guide, crf, pif, bb.board->ub());
+			if(bb.publishPrimal(inst, sol)) nImproved++;
+		} else {
+			Sol sol = primI(inst.r, inst, job.c);
+			if(bb.publishPrimal(inst, sol)) nImproved++;
+		}
+
+		lock.lock();
+	}
+}
+
+// Parallel branch-and-bound: every worker is a tree with its own dual ascent workspace, guiding
+// solutions and branching priorities, whose node queues serve as local node pool. Owners select nodes
+// according to the node selection strategy, idle workers steal the node with the best bound from
+// another worker. Improving solutions are published to the master tree, from which the workers
+// pick up the incumbent.
+class BBTree::ParallelSearch
+{
+public:
+	ParallelSearch(BBTree& bb, Timer& tBB);
+
+	void run();
+	int  openNodes() { return nOpen; }
+	// open nodes and nodes in process
+	vector<ReoptRegion> openRegions();
+
+private:
+	struct Slot
+	{
+		unique_ptr<BBTree> tree;
+		mutex mtx;                  // guards the node queues of tree
+		atomic<weight_t> lb{WMAX};  // bound of the node in process
+		mutex mtxNode;              // guards node
+		BBNode* node = nullptr;     // node in process, for checkpoints
+	};
+	void     setNode(Slot& s, BBNode* b);
+
+	void     work(int id);
+	BBNode*  steal(int id);
+	weight_t bound();
+	void     stop(State s);
+
+	BBTree& bb;
+	Timer& tBB;
+	vector<unique_ptr<Slot>> slots;
+	// open nodes include the nodes in process, so the search is finished once it drops to zero
+	atomic<int> nOpen{0}, nIter{0}, state{(int)BB_NONE};
+	mutex mtxPrint;
+};
+
+BBTree::ParallelSearch::ParallelSearch(BBTree& bb, Timer& tBB) : bb(bb), tBB(tBB)
+{
+	for(int id = 0; id < params.threads; id++) {
+		slots.emplace_back(new Slot());
+		slots[id]->tree.reset(new BBTree(bb, bb.inst, id));
+		slots[id]->tree->search = this;
+		slots[id]->tree->bOutput = bb.bOutput;
+	}
+
+	// deal the open nodes in order of their bound
+	for(int i = 0; !bb.PQmin.empty(); i++) {
+		BBNode* b = bb.PQmin.top().second;
+		bb.PQmin.pop();
+		slots[i % slots.size()]->tree->add(b);
+		nOpen++;
+	}
+	bb.PQmax.clear();
+	bb.plungeNode = nullptr;
+}
+
+void BBTree::ParallelSearch::run()
+{
+	runThreads((int)slots.size(), [this](int id) { work(id); });
+	bb.syncIncumbent();
+	if(bb.heur == nullptr)
+		bb.board->reclaim();
+
+	// remaining open nodes are handed back to the master tree
+	for(auto& s : slots) {
+		BBTree& w = *s->tree;
+		while(!w.PQmin.empty()) {
+			BBNode* b = w.PQmin.top().second;
+			w.PQmin.pop();
+			bb.add(b);
+		}
+		w.PQmax.clear();
+		w.plungeNode = nullptr;
+	}
+
+	bb.nIter = nIter;
+	bb.tState = (State)state.load();
+	if(bb.PQmin.empty() || bb.PQmin.top().first >= bb.ub) {
+		bb.tState = BB_OPTIMAL;
+	}
+	bb.bestlb = bb.PQmin.empty() ? bb.ub : bb.PQmin.top().first;
+}
+
+void BBTree::ParallelSearch::work(int id)
+{
+	Slot& s = *slots[id];
+	BBTree& w = *s.tree;
+
+	while(state == BB_NONE) {
+		BBNode* b = nullptr;
+		{
+			lock_guard<mutex> lock(s.mtx);
+			if(!w.PQmin.empty()) {
+				b = w.select();
+				s.lb = b->lb;
+				setNode(s, b);
+			}
+		}
+		if(b == nullptr) {
+			b = steal(id);
+		}
+		if(b == nullptr) {
+			if(nOpen == 0) break;
+			this_thread::sleep_for(chrono::microseconds(100));
+			continue;
+		}
+
+		// nodes that cannot improve the incumbent any more are discarded without processing
+		w.syncIncumbent();
+		if(w.ub - b->lb <= params.absgap) {
+			s.lb = WMAX;
+			setNode(s, nullptr);
+			w.closeRegion(b->path, b->lb);
+			delete b->inst;
+			delete b;
+			nOpen--;
+			continue;
+		}
+
+		// the node limit is enforced when a node is taken, nodes in process count towards it
+		const int it = ++nIter;
+		if(it > bb.nodeLim) {
+			nIter--;
+			lock_guard<mutex> lock(s.mtx);
+			w.add(b);
+			s.lb = WMAX;
+			setNode(s, nullptr);
+			stop(BB_NODELIMIT);
+			break;
+		}
+
+		if(bb.spill != nullptr)
+			bb.spill->unspill(b);
+		b->restore();
+
+		NodeState nstate;
+		bool bBranch = true;
+		if(!b->processed) {
+			nstate = w.process(b);
+			switch(nstate) {
+				case BB_INFEAS:
+				case BB_CUTOFF:
+					if(b->v != -1)
+						w.prio[b->v]++;
+					bBranch = false;
+					break;
+				case BB_LEAF:
+					w.evalLeaf(b);
+					bBranch = false;
+					break;
+				case BB_BRANCH:
+					w.selectBranchVariable(b);
+					break;
+			}
+		} else {
+			nstate = (NodeState)b->state;
+		}
+
+		// the lower bound of any portfolio member is valid for all of them, b still counts with its
+		// bound before branching
+		bool bPortfolioOpt = false;
+		if(bb.portfolio != nullptr && !bb.bHeur) {
+			w.syncIncumbent();
+			atomicMax(bb.portfolio->lb, min(bound(), w.ub));
+			bPortfolioOpt = (bb.portfolio->lb >= w.ub);
+		}
+
+		State st = BB_NONE;
+		if ( it >= bb.nodeLim )                        st = BB_NODELIMIT;
+		if ( bb.nImprovements >= bb.solLim )           st = BB_SOLLIMIT;
+		if ( bb.timeUp(tBB) )                          st = BB_TIMELIMIT;
+		if ( bb.memUsed() > bb.memLimit())             st = BB_MEMLIMIT;
+		if ( bPortfolioOpt )                           st = BB_OPTIMAL;
+		if(st != BB_NONE) {
+			stop(st);
+		}
+
+		const bool bExit = (st != BB_NONE);
+		const bool bPrint = bb.bOutput && (it % params.bbinfofreq == 0 || it == 1 || bExit);
+		const weight_t lbAll = bPrint ? bound() : 0;
+
+		// once b is back in the queue it may be stolen, so it is only accessed under the lock. The
+		// children are counted before the lock is released, as a thief may finish them right away.
+		bool bDelete;
+		{
+			lock_guard<mutex> lock(s.mtx);
+			if(bBranch) {
+				const int size = (int)w.PQmin.size();
+				w.branch(b);
+				nOpen += (int)w.PQmin.size() - size;
+			}
+			bDelete = (nstate != BB_BRANCH || !b->feas);
+
+			if(bPrint) {
+				lock_guard<mutex> lockPrint(mtxPrint);
+				w.syncIncumbent();
+				w.nIter = it;
+				w.bestlb = min(lbAll, w.ub);
+				w.printBBLine(b, nstate, true);
+			}
+			s.lb = WMAX;
+			setNode(s, nullptr);
+		}
+		nOpen--;
+
+		if(bb.spill != nullptr && it % spillCheckFreq == 0) {
+			lock_guard<mutex> lock(s.mtx);
+			w.spillNodes();
+		}
+
+		if(id == 0 && bb.checkpointDue())
+			bb.writeCheckpoint(openRegions(), w.prio);
+
+		if(bDelete) {
+			w.closeRegion(b->path, b->lb);
+			delete b->inst;
+			b->inst = nullptr;
+			delete b;
+		}
+	}
+}
+
+BBNode* BBTree::ParallelSearch::steal(int id)
+{
+	const int n = (int)slots.size();
+	for(int k = 1; k < n; k++) {
+		Slot& v = *slots[(id+k) % n];
+		lock_guard<mutex> lock(v.mtx);
+		BBTree& w = *v.tree;
+		if(w.PQmin.empty()) continue;
+
+		BBNode* b = w.PQmin.top().second;
+		w.PQmin.erase(b->pqposMin);
+		if(params.nodeselect != 2) {
+			w.PQmax.erase(b->pqposMax);
+		}
+		if(w.plungeNode == b)
+			w.plungeNode = nullptr;
+		// registered before the lock is released, so that checkpoints do not miss it
+		slots[id]->lb = b->lb;
+		setNode(*slots[id], b);
+		return b;
+	}
+	return nullptr;
+}
+
+void BBTree::ParallelSearch::setNode(Slot& s, BBNode* b)
+{
+	lock_guard<mutex> lock(s.mtxNode);
+	s.node = b;
+}
+
+vector<ReoptRegion> BBTree::ParallelSearch::openRegions()
+{
+	// queue locks are taken in order, workers only hold one of them (and the node lock of a slot)
+	vector<unique_lock<mutex>> locks;
+	for(auto& s : slots)
+		locks.emplace_back(s->mtx);
+
+	vector<ReoptRegion> regions;
+	for(auto& s : slots) {
+		for(auto& e : s->tree->PQmin) {
+			BBNode* b = e.second;
+			if(b->path != nullptr)
+				regions.push_back(ReoptRegion{b->lb, pathSteps(b->path)});
+		}
+		lock_guard<mutex> lock(s->mtxNode);
+		if(s->node != nullptr && s->node->path != nullptr)
+			regions.push_back(ReoptRegion{s->lb, pathSteps(s->node->path)});
+	}
+	return regions;
+}
+
+weight_t BBTree::ParallelSearch::bound()
+{
+	// all queues are locked at once (in order, like openRegions), a node stolen in between would be
+	// missed otherwise
+	vector<unique_lock<mutex>> locks;
+	for(auto& s : slots)
+		locks.emplace_back(s->mtx);
+
+	weight_t lb = WMAX;
+	for(auto& s : slots) {
+		if(!s->tree->PQmin.empty()) {
+			lb = min(lb, s->tree->PQmin.top().first);
+		}
+		lb = min(lb, s->lb.load());
+	}
+	return lb;
+}
+
+void BBTree::ParallelSearch::stop(State s)
+{
+	int expected = BB_NONE;
+	state.compare_exchange_strong(expected, (int)s);
+}
+
+void BBTree::solveParallel(Timer& tBB)
+{
+	ParallelSearch ps(*this, tBB);
+	ps.run();
+}
+
+int BBTree::openNodes()
+{
+	return search != nullptr ? search->openNodes() : (int)PQmin.size();
+}
+
 void BBTree::solve()
 {
 	if(cutup >= 0.0 && cutup < ub) {
-		ub = cutup;
+		board->cutUp(cutup);
+		syncIncumbent();
 	}
 
 	bool bSolvedInRoot = false, bOutOfMemInRoot = false;
 	if(!processedRoots) {
-		processRoots();
+		if(!reoptRoots())
+			processRoots();
 		processedRoots = true;
 	}
 
@@ -448,10 +1320,26 @@ void BBTree::solve()
 	nImprovements = 0;
 	nIter = 0;
 	Timer tBB(true);
+	tCheckpoint.start();
+
+	unique_ptr<AsyncHeur> asyncHeur;
+	if(params.heurasync > 0 && !bHeur && !bRecover && !PQmin.empty()) {
+		asyncHeur.reset(new AsyncHeur(*this));
+		heur = asyncHeur.get();
+	}
 	
+	if(params.spill > 0 && params.bbtrail && !bHeur && !PQmin.empty())
+		spill.reset(new NodeSpill(params.spilldir));
+
+	if(params.threads > 1 && !PQmin.empty()) {
+		solveParallel(tBB);
+	} else
 	while ( !PQmin.empty() ) {
 		
 		BBNode* b = select();
+		if(spill != nullptr)
+			spill->unspill(b);
+		b->restore();
 		
 		NodeState state;
 		if(!b->processed) {
@@ -481,25 +1369,57 @@ void BBTree::solve()
 			bestlb = ub;
 		}
 
+		// the lower bound of any portfolio member is valid for all of them
+		bool bPortfolioOpt = false;
+		if(portfolio != nullptr && !bHeur) {
+			atomicMax(portfolio->lb, min(bestlb, ub));
+			bPortfolioOpt = (portfolio->lb >= ub);
+		}
+
 		bool bExit = false;
 		if ( ++nIter >= nodeLim )                          { tState = BB_NODELIMIT; bExit = true; }
 		if ( nImprovements >= solLim )                     { tState = BB_SOLLIMIT;  bExit = true; }
-		if ( tBB.elapsed().getSeconds() > timeLim )        { tState = BB_TIMELIMIT; bExit = true; }
-		if ( ProcStatus::mem() > params.memlimit)          { tState = BB_MEMLIMIT;  bExit = true; }
+		if ( timeUp(tBB) )                                 { tState = BB_TIMELIMIT; bExit = true; }
+		if ( memUsed() > memLimit())                       { tState = BB_MEMLIMIT;  bExit = true; }
 		if ( PQmin.size() == 0 || PQmin.top().first >= ub) { tState = BB_OPTIMAL;   bExit = true; }
+		if ( bPortfolioOpt )                               { tState = BB_OPTIMAL;   bExit = true; }
 
 		printBBLine(b, state, bExit);
 
+		if(spill != nullptr && !bExit && nIter % spillCheckFreq == 0)
+			spillNodes();
+
 		// case two occurs when both nodes get pruned
 		if ( state != BB_BRANCH || (state == BB_BRANCH && !b->feas)) {
+			closeRegion(b->path, b->lb);
 			delete b->inst;
 			b->inst = nullptr;
 			delete b;
 		}
 
+		if(!bExit && checkpointDue())
+			writeCheckpoint(openRegions(), prio);
+
 		if(bExit) break;
 	}
 
+	// solutions of the heuristic threads may still arrive until they are stopped
+	heur = nullptr;
+	asyncHeur.reset();
+	syncIncumbent();
+	bestlb = min(bestlb, ub);
+
+	// the first portfolio member proving optimality stops the others
+	if(portfolio != nullptr && !bHeur) {
+		if(tState == BB_OPTIMAL) {
+			atomicMax(portfolio->lb, ub);
+			int none = -1;
+			portfolio->winner.compare_exchange_strong(none, portfolioIndex);
+			portfolio->stop = true;
+		}
+		importPortfolioBounds();
+	}
+
 	const double finishedTime = tBB.elapsed().getSeconds();
 
 	// heuristic should not affect optimality gap
@@ -514,9 +1434,22 @@ void BBTree::solve()
 		inc1 = Sol(inst1);
 		inc1.nodes[bestSingleNodeSolNode] = true;
 		inc1.r = bestSingleNodeSolNode;
+		inc1Version = board->version();
+		board->cutUp(ub);
+	}
+
+	// the final checkpoint is complete when the solve returns
+	if(!checkpointFile.empty() && !bHeur) {
+		writeCheckpoint(openRegions(), prio);
+		checkpointWriter->join();
+		checkpointWriter.reset();
 	}
 
 	freeOpenNodes();
+	if(spill != nullptr) {
+		stats.spillmb = max(stats.spillmb, spill->size() / (1024.0 * 1024.0));
+		spill.reset();
+	}
 
 	if(bOutput) {
 		printf(" --- ");
@@ -534,6 +1467,8 @@ void BBTree::solve()
 	}
 	
 	// recover a partial solution (which may contain antiparallel arcs)
+	syncOriginal();
+	board->reclaim();
 	if(!bRecover && inc1.partial) {
 		recoverPartialSol(inc1, inst1);
 	}
@@ -549,6 +1484,7 @@ void BBTree::add(BBNode* b)
 			b->pqposMax = PQmax.push(make_pair(b->lb, b));
 			break;
 		case 1:  // dfs
+		case 3:  // hybrid, the deepest node is taken when there are too many open nodes
 			b->pqposMax = PQmax.push(make_pair(b->depth, b));
 			break;
 	}
@@ -557,15 +1493,26 @@ void BBTree::add(BBNode* b)
 	b->pqposMin = PQmin.push(make_pair(b->lb, b));
 }
 
-BBNode* BBTree::makeRoot(int r, weight_t lb, vector<int>& fe0)
+BBNode* BBTree::makeRoot(int r, weight_t lb, vector<int>& fe0, shared_ptr<const BranchPath> path)
 {
 	BBNode* b = new BBNode(&inst, r, fe0);
+	b->path = path;
 	b->updateNodeSize();
+
+	// dual solution of the root in a previous solve, validated by warmStart
+	const BBTree& top = (master != nullptr) ? *master : *this;
+	if(top.reopt != nullptr && !bHeur) {
+		auto it = top.reopt->roots.find(r);
+		if(it != top.reopt->roots.end())
+			b->duals = it->second.duals;
+	}
+
 	NodeState state = process(b);
 	
 	b->state = (int)state;
 
 	if(state == BB_INFEAS || state == BB_CUTOFF) {
+		closeRegion(b->path, b->lb);
 		delete b->inst;
 		delete b;
 		return nullptr;
@@ -573,6 +1520,7 @@ BBNode* BBTree::makeRoot(int r, weight_t lb, vector<int>& fe0)
 		switch(state) {
 			case BB_LEAF:
 				evalLeaf(b);
+				closeRegion(b->path, b->lb);
 				break;
 			case BB_BRANCH:
 				selectBranchVariable(b);
@@ -629,7 +1577,9 @@ BBTree::NodeState BBTree::strengthenBounds(BBNode* b)
 	int maxsize = min(params.daiterations-1, (int)pool.size());
 	for(int i = 0; i < maxsize; i++) {
 		
-		lb = daR(b->inst->r, *b->inst, b->inst->c, cr, pi, ub, params.daeager, pool[i]);
+		lb = daR(b->inst->r, *b->inst, b->inst->c, cr, pi, ub, params.daeager, pool[i], false, false, board->liveUB());
+		syncIncumbent();
+		saveDuals(b, lb);
 		b->lb = max(b->lb, lb);
 		if(ub - b->lb <= params.absgap) {
 			return BB_CUTOFF;
@@ -648,19 +1598,94 @@ BBTree::NodeState BBTree::strengthenBounds(BBNode* b)
 	return BB_BRANCH;
 }
 
+bool BBTree::warmStart(BBNode* b)
+{
+	if(b->duals == nullptr) return false;
+	auto duals = b->duals;
+	b->duals.reset();
+
+	// the cuts of the parent's duals stay valid as long as no arc changed its endpoints,
+	// fixings and deletions of nodes and arcs only drop constraints
+	Inst& inst = *b->inst;
+	if(inst.bigM >= 0 || inst.arcMoves != duals->arcMoves) return false;
+	// duals of a previous solve require the same arcs, as additional arcs may violate their cuts
+	if(duals->structure != 0 && duals->structure != structureHash(inst)) return false;
+
+	for(int ij = 0; ij < inst.m; ij++) {
+		if(inst.fe0[ij]) continue;
+		cr[ij] = inst.c[ij];
+	}
+	for(auto& e : duals->arcs) {
+		const int ij = e.first;
+		if(inst.fe0[ij]) continue;
+		// costs may have been lowered by reductions
+		if(cr[ij] < e.second) return false;
+		cr[ij] -= e.second;
+	}
+
+	for(int i = 0; i < inst.n; i++) {
+		if(!inst.T[i] || i == inst.r) continue;
+		pi[i] = inst.f1[i] ? WMAX : inst.p[i];
+	}
+	for(auto& e : duals->nodes) {
+		const int i = e.first;
+		// revenue consumed for removed nodes is lost, but the bound remains valid
+		if(inst.f0[i]) continue;
+		if(!inst.T[i] || i == inst.r || pi[i] < e.second) return false;
+		pi[i] -= e.second;
+	}
+	return true;
+}
+
+void BBTree::saveDuals(BBNode* b, weight_t lb)
+{
+	if(!params.bbwarmstart || b->inst->bigM >= 0) return;
+	if(b->duals != nullptr && b->duals->lb >= lb) return;
+
+	Inst& inst = *b->inst;
+	auto duals = make_shared<DualState>();
+	for(int ij = 0; ij < inst.m; ij++) {
+		if(inst.fe0[ij] || cr[ij] >= inst.c[ij]) continue;
+		duals->arcs.push_back(make_pair(ij, inst.c[ij] - cr[ij]));
+	}
+	for(int i = 0; i < inst.n; i++) {
+		if(!inst.T[i] || i == inst.r) continue;
+		const weight_t p = inst.f1[i] ? WMAX : inst.p[i];
+		if(pi[i] >= p) continue;
+		duals->nodes.push_back(make_pair(i, p - pi[i]));
+	}
+	duals->lb = lb;
+	duals->arcMoves = inst.arcMoves;
+	b->duals = duals;
+}
+
 BBTree::NodeState BBTree::process(BBNode* b)
 {
 	b->processed = true;
+	b->kept = false;
 	Inst& inst = *b->inst;
 
-	if(b->depth == 0 || !params.redrootonly)
+	syncIncumbent();
+
+	// while regions are recorded, nodes below the roots are restricted to bound-based reductions (see reopt.h)
+	const bool bRecording = (master != nullptr) ? master->bRecord : bRecord;
+	if(b->depth == 0 || (!params.redrootonly && (b->path == nullptr || !bRecording)))
 		preprocess(inst);
 
 	b->feas = isFeas(inst);
 	if(!b->feas) return BB_INFEAS;
 
+	if(b->depth == 0 && (b->path != nullptr || reopt != nullptr))
+		b->rootHash = structureHash(inst);
+
 	// improve dual bound
-	weight_t lb = daR(b->inst->r, inst, inst.c, cr, pi, ub, params.daeager, &inc);
+	const bool warm = warmStart(b);
+	// the dual ascent stops once the bound of the board is reached, which may be lowered meanwhile
+	weight_t lb = daR(b->inst->r, inst, inst.c, cr, pi, ub, params.daeager, &inc, false, warm, board->liveUB());
+	syncIncumbent();
+	saveDuals(b, lb);
+	if(b->depth == 0 && b->path != nullptr)
+		recordRoot(inst.r, b);
 	
 	b->lb = max(b->lb, lb);
 	if(ub - b->lb <= params.absgap) return BB_CUTOFF;
@@ -677,8 +1702,12 @@ BBTree::NodeState BBTree::process(BBNode* b)
 	auto state = strengthenBounds(b);
 	if(state == BB_CUTOFF || state == BB_INFEAS) return state;
 
-	// try perturbed heuristic
-	if(params.perturbedheur) {
+	// try perturbed heuristic, on the heuristic threads if available
+	AsyncHeur* h = (master != nullptr) ? master->heur : heur;
+	if(h != nullptr) {
+		h->submit(inst, params.perturbedheur ? vector<weight_t>() : setSupportGraph(inst));
+		syncIncumbent();
+	} else if(params.perturbedheur) {
 		perturbedPrimalHeur(inst);
 	} else {
 		auto c1 = setSupportGraph(inst);
@@ -713,37 +1742,35 @@ void BBTree::branch(BBNode* b)
 		b1feas = isFeas(*b->inst, false);
 		b->inst->f1[v] = false;
 
+		// open nodes are stored as difference to the base instance of their subtree, except for the
+		// child that keeps the instance of its parent until the next node is selected (see select)
 		if(b0feas && b1feas) {
-			// both feasible, need to copy
+			// both feasible, need to copy (stored nodes share the parent instance instead)
+			if(params.bbtrail)
+				b->keep();
 			BBNode* b0 = new BBNode(b, v, 0);
 			add(b0);
 
-			b->inst->f1[v] = true;
-			b->inst->T[v] = true;
-			b->inst->p[v] = WMAX;
+			if(b->path != nullptr)
+				b->path = BranchPath::extend(b->path, v, BranchPath::IN);
 			b->v = v;
 			b->bdir = 1;
 			b->depth++;
 			b->processed = false;
+			b->applyBranch();
 			add(b);
+			plungeNode = b;
 
-		} else if(b0feas) {
-			b->inst->removeNode(v);
+		} else if(b0feas || b1feas) {
+			if(b->path != nullptr)
+				b->path = BranchPath::extend(b->path, v, b0feas ? BranchPath::OUT : BranchPath::IN);
 			b->v = v;
-			b->bdir = 0;
-			b->depth++;
-			b->processed = false;
-			add(b);
-
-		} else if(b1feas) {
-			b->inst->f1[v] = true;
-			b->inst->T[v] = true;
-			b->inst->p[v] = WMAX;
-			b->v = v;
-			b->bdir = 1;
+			b->bdir = b0feas ? 0 : 1;
 			b->depth++;
 			b->processed = false;
+			b->applyBranch();
 			add(b);
+			plungeNode = b;
 
 		} else {
 			// both pruned, delete later
@@ -764,6 +1791,7 @@ int BBTree::selectBranchVariable(BBNode* b)
 	Inst& inst = (*b->inst);
 	int dmax = -1, dmaxS = -1, priomax = -1, v = -1;
 	weight_t pmax = 0.0;
+	vector<tuple<int,int,int,int>> cands;
 
 	for(int i = 0; i < inst.n; i++) {
 		if(inst.f1[i] || inst.f0[i]) continue;
@@ -778,7 +1806,9 @@ int BBTree::selectBranchVariable(BBNode* b)
 
 		const int prio1 = prio[i];
 
-		if(params.branchtype == 0) {
+		if(params.branchtype == 4) {
+			cands.push_back(make_tuple(prio1, deg, degS, -i));
+		} else if(params.branchtype == 0) {
 			if( ( priomax  < prio1 ) || 
 				( priomax == prio1 && deg > dmax ) || 
 				( priomax == prio1 && deg == dmax && degS > dmaxS ) ) {
@@ -812,11 +1842,81 @@ int BBTree::selectBranchVariable(BBNode* b)
 		}
 	}
 
+	if(!cands.empty())
+		v = selectReliable(b, cands);
+
 	b->v2 = v;
 
 	return v;
 }
 
+int BBTree::selectReliable(BBNode* b, vector<tuple<int,int,int,int>>& cands)
+{
+	// candidates in the order of --bb.branchtype 0, the first ones without reliable pseudo-costs are probed
+	sort(cands.begin(), cands.end(), greater<tuple<int,int,int,int>>());
+
+	int v = -get<3>(cands[0]), nProbed = 0;
+	double best = -1.0;
+	weight_t lb0 = -1;
+	for(auto& cand : cands) {
+		const int i = -get<3>(cand);
+		double gain[2];
+		if(min(pcCnt[0][i], pcCnt[1][i]) >= params.reliability) {
+			for(int d = 0; d < 2; d++)
+				gain[d] = pcSum[d][i] / pcCnt[d][i];
+		} else if(nProbed < params.relcands) {
+			if(nProbed++ == 0)
+				lb0 = probe(b, -1, -1);
+			bool bPruned = false;
+			for(int d = 0; d < 2; d++) {
+				const weight_t lb = min(probe(b, i, d), ub);
+				gain[d] = max(lb - lb0, (weight_t)0);
+				pcSum[d][i] += gain[d];
+				pcCnt[d][i]++;
+				if(ub - lb <= params.absgap) bPruned = true;
+			}
+			// one of the children is pruned, branching fixes the node
+			if(bPruned) return i;
+		} else {
+			continue;
+		}
+
+		// product of the gains, so that both children are required to improve
+		const double score = max(gain[0], 1e-6) * max(gain[1], 1e-6);
+		if(score > best) {
+			best = score;
+			v = i;
+		}
+	}
+
+	return v;
+}
+
+weight_t BBTree::probe(BBNode* b, int v, int bdir)
+{
+	Inst& inst = *b->inst;
+	if(v != -1) {
+		vector<flag_t>& fix = (bdir == 0) ? inst.f0 : inst.f1;
+		fix[v] = true;
+		const bool feas = isFeas(inst, false);
+		fix[v] = false;
+		if(!feas) return ub;
+		stats.probes++;
+	}
+
+	// the dual ascent restarts from the costs, since the duals of the node rarely change after
+	// a single fixing. Gains are measured against a restart on the node itself (v = -1).
+	probeInst = inst;
+	if(bdir == 0) {
+		probeInst.removeNode(v);
+	} else if(bdir == 1) {
+		probeInst.f1[v] = true;
+		probeInst.T[v] = true;
+		probeInst.p[v] = WMAX;
+	}
+	return daR(probeInst.r, probeInst, probeInst.c, cr, pi, ub, params.daeager, &inc, false, false, board->liveUB(), params.probeiter);
+}
+
 int BBTree::preprocess(Inst& inst)
 {
 	vector<flag_t> ap;
@@ -864,12 +1964,14 @@ void BBTree::freeOpenNodes()
 	while(!PQmin.empty()) {
 		auto b = PQmin.top().second;
 		PQmin.pop();
+		closeRegion(b->path, b->lb);
 		delete b->inst;
 		b->inst = 0;
 		delete b;
 	}
 	PQmax.clear();
 	PQmin.clear();
+	plungeNode = nullptr;
 }
 
 vector<int> BBTree::sortedListPotentialRoots()
@@ -907,6 +2009,28 @@ void BBTree::fixTerm(Inst& inst, int t, vector<int>& fe0)
 	inst.p[t] = 0;
 }
 
+void BBTree::spillNodes()
+{
+	NodeSpill* f = spillFile();
+	if(f == nullptr || memUsed() <= params.spill * memLimit() || !f->open())
+		return;
+
+	// stored nodes in the order of selection, the half selected last is spilled
+	vector<pair<weight_t,BBNode*>> nodes;
+	for(auto& e : PQmin) {
+		BBNode* b = e.second;
+		if(b->inst != nullptr || b->spillPos >= 0) continue;
+		weight_t key = b->lb;
+		if(params.nodeselect == 1) key = b->depth;
+		if(params.nodeselect == 2 || params.nodeselect == 3) key = -b->lb;
+		nodes.push_back(make_pair(key, b));
+	}
+	sort(nodes.begin(), nodes.end(), [](const pair<weight_t,BBNode*>& a, const pair<weight_t,BBNode*>& b) { return a.first > b.first; });
+
+	for(size_t k = nodes.size()/2; k < nodes.size(); k++)
+		f->spill(nodes[k].second);
+}
+
 BBNode* BBTree::select()
 {
 	BBNode* b;
@@ -925,8 +2049,29 @@ BBNode* BBTree::select()
 			b = PQmin.top().second;
 			PQmin.erase(b->pqposMin);
 			break;
+		case 3: // hybrid: plunges into the child of the last node while its bound is close to the best bound
+			b = nullptr;
+			if(plungeNode != nullptr) {
+				const weight_t lb0 = PQmin.top().first;
+				if(plungeNode->lb - lb0 <= params.plungequot * (ub - lb0))
+					b = plungeNode;
+			}
+			if(b == nullptr) {
+				const bool bDeep = (params.plungeopen > 0 && (int)PQmin.size() > params.plungeopen);
+				b = bDeep ? PQmax.top().second : PQmin.top().second;
+			}
+			PQmax.erase(b->pqposMax);
+			PQmin.erase(b->pqposMin);
+			break;
 	}
-	
+
+	// the child of the last node keeps the instance of its parent only if it is processed next
+	if(plungeNode != nullptr) {
+		if(plungeNode != b && params.bbtrail)
+			plungeNode->store();
+		plungeNode = nullptr;
+	}
+
 	return b;
 }
 
@@ -956,7 +2101,520 @@ void BBTree::evalLeaf(BBNode* b)
 int BBTree::initPrep()
 {
 	preprocess(inst);
+	initSemiBigM();
+	return 0;
+}
+
+void BBTree::loadPrep(const char* fn)
+{
+	if(!loadPresolved(fn, inst1, inst)) {
+		EXIT("error: presolve snapshot %s is invalid or belongs to a different instance\n", fn);
+	}
+	initSemiBigM();
+}
 
+void BBTree::savePrep(const char* fn)
+{
+	writePresolved(fn, inst1, inst);
+}
+
+void BBTree::setReoptState(const ReoptState& s)
+{
+	if(s.instHash != structureHash(inst1)) {
+		EXIT("error: reoptimization state belongs to a different instance\n");
+	}
+	// the incumbent is revalidated after preprocessing, see reoptRoots
+	reopt = &s;
+}
+
+void BBTree::setResume(const ReoptState& s)
+{
+	if(s.instHash != structureHash(inst1)) {
+		EXIT("error: checkpoint belongs to a different instance\n");
+	}
+	reopt = &s;
+	bResume = true;
+}
+
+bool BBTree::stateIncumbent(const ReoptState& s, Sol& sol)
+{
+	if((int)s.solNodes.size() != inst1.n || (int)s.solArcs.size() != inst1.m || s.solRoot == -1)
+		return false;
+	sol.nodes = s.solNodes;
+	sol.arcs = s.solArcs;
+	sol.r = s.solRoot;
+	for(int i = 0; i < inst1.n; i++) {
+		if(inst1.f1[i] && !sol.nodes[i]) return false;
+	}
+	sol.recomputeObjective();
+	return sol.validate();
+}
+
+Sol BBTree::originalIncumbent()
+{
+	int version;
+	Sol S = board->original(version);
+	if(version == inc1Version)
+		S = inc1;
+	if(S.partial)
+		recoverPartialSol(S, inst1);
+	return S;
+}
+
+vector<ReoptRegion> BBTree::openRegions()
+{
+	vector<ReoptRegion> regions;
+	for(auto& e : PQmin) {
+		BBNode* b = e.second;
+		if(b->path != nullptr)
+			regions.push_back(ReoptRegion{b->lb, pathSteps(b->path)});
+	}
+	return regions;
+}
+
+void BBTree::writeCheckpoint(vector<ReoptRegion> regions, const vector<int>& prio)
+{
+	tCheckpoint.start();
+
+	auto s = make_shared<ReoptState>();
+	s->instHash = structureHash(inst1);
+	s->complete = bRootsComplete;
+	s->regions = std::move(regions);
+	{
+		lock_guard<mutex> lock(mtxRecord);
+		s->prepHash = record.prepHash;
+		s->prepC = record.prepC;
+		s->prepP = record.prepP;
+		s->prepOffset = record.prepOffset;
+		s->roots = record.roots;
+	}
+	Sol S = originalIncumbent();
+	s->solNodes = S.nodes;
+	s->solArcs = S.arcs;
+	s->solRoot = S.r;
+	s->prio = prio;
+
+	// the previous checkpoint is complete before it is replaced
+	if(checkpointWriter != nullptr)
+		checkpointWriter->join();
+	checkpointWriter.reset(new ThreadGroup());
+	const string fn = checkpointFile;
+	checkpointWriter->start([s, fn](int) { writeReoptState(fn.c_str(), *s); });
+}
+
+void BBTree::saveReoptState(const char* fn)
+{
+	// open nodes remain if the search stopped after the roots
+	for(auto& e : PQmin) {
+		closeRegion(e.second->path, e.second->lb);
+	}
+
+	record.instHash = structureHash(inst1);
+	record.complete = bRootsComplete;
+	syncOriginal();
+	Sol S = inc1;
+	if(S.partial)
+		recoverPartialSol(S, inst1);
+	record.solNodes = S.nodes;
+	record.solArcs = S.arcs;
+	record.solRoot = S.r;
+	writeReoptState(fn, record);
+}
+
+void BBTree::recordPrep()
+{
+	if(!bPaths) return;
+	record.prepHash = structureHash(inst);
+	record.prepC = inst.c;
+	record.prepP = inst.p;
+	record.prepOffset = inst.offset;
+}
+
+void BBTree::closeRegion(const shared_ptr<const BranchPath>& path, weight_t lb)
+{
+	const bool bRecording = (master != nullptr) ? master->bRecord : bRecord;
+	if(path == nullptr || bHeur || !bRecording) return;
+
+	// bound-based reductions only keep solutions better than the incumbent, the bound of the board
+	// is not above any bound used by them
+	lb = min(lb, board->ub());
+	if(master != nullptr)
+		master->addRegion(path, lb);
+	else
+		addRegion(path, lb);
+}
+
+void BBTree::addRegion(const shared_ptr<const BranchPath>& path, weight_t lb)
+{
+	ReoptRegion region{lb, pathSteps(path)};
+	lock_guard<mutex> lock(mtxRecord);
+	record.regions.push_back(std::move(region));
+}
+
+void BBTree::recordRoot(int r, const BBNode* b)
+{
+	if(master != nullptr) {
+		master->recordRoot(r, b);
+		return;
+	}
+	lock_guard<mutex> lock(mtxRecord);
+	ReoptRoot& root = record.roots[r];
+	root.hash = b->rootHash;
+	root.duals = b->duals;
+
+	// the weights of the root instance are stored as changes of the preprocessed instance
+	const Inst& rinst = *b->inst;
+	root.c.clear();
+	root.p.clear();
+	for(int ij = 0; ij < rinst.m; ij++) {
+		if(rinst.c[ij] != record.prepC[ij]) root.c.push_back(make_pair(ij, rinst.c[ij]));
+	}
+	for(int i = 0; i < rinst.n; i++) {
+		if(rinst.p[i] != record.prepP[i]) root.p.push_back(make_pair(i, rinst.p[i]));
+	}
+	root.offset = rinst.offset;
+}
+
+// Replaces the root processing by the regions of the previous solve. If preprocessing yields the same
+// instance, regions whose bound, lowered by the decrease of the weights they may use, still exceeds the
+// incumbent remain closed and only the roots of the other regions are processed again. Otherwise, all
+// roots are processed again. If the reduction tests of a root yield the same instance, its regions are
+// added as open nodes below it, with bounds lowered by the decrease of the weights of the root instance,
+// otherwise the root is added as a single open node.
+bool BBTree::reoptRoots()
+{
+	if(reopt == nullptr) return false;
+	const ReoptState& s = *reopt;
+
+	// the incumbent is revalidated on the new weights and mapped to the preprocessed instance, if it
+	// cannot be mapped its bound is a cutoff
+	Sol sol1(inst1);
+	if(stateIncumbent(s, sol1) && sol1.obj < ub) {
+		Sol sol(inst);
+		if(mapSolution(sol1, inst, sol))
+			updatePrimal(inst, sol);
+		if(sol1.obj < ub) {
+			inc1 = sol1;
+			board->cutUp(sol1.obj);
+			syncIncumbent();
+			inc1Version = board->version();
+		}
+	}
+	if(bResume && s.prio.size() == prio.size())
+		prio = s.prio;
+
+	const bool bSamePrep = (s.prepHash == structureHash(inst));
+	if((int)s.prepC.size() != inst.m || (int)s.prepP.size() != inst.n || !s.complete) {
+		if(bOutput)
+			printf(" --- previous solve incomplete or of a different size, its regions are not reused\n");
+		return false;
+	}
+
+	// decreases of the weights of an instance, changes of fixed weights are changes of the structure
+	struct Decrease {
+		vector<pair<int,weight_t>> arcs, nodes;
+		weight_t offset;
+	};
+	auto decrease = [&](const Inst& in, const vector<weight_t>& c0, const vector<weight_t>& p0, weight_t offset0, Decrease& d) -> bool {
+		for(int ij = 0; ij < in.m; ij++) {
+			if(in.fe0[ij] || in.c[ij] >= c0[ij]) continue;
+			if(c0[ij] == WMAX) return false;
+			d.arcs.push_back(make_pair(ij, c0[ij] - in.c[ij]));
+		}
+		for(int i = 0; i < in.n; i++) {
+			if(in.p[i] >= p0[i]) continue;
+			if(p0[i] == WMAX) return false;
+			d.nodes.push_back(make_pair(i, p0[i] - in.p[i]));
+		}
+		d.offset = max((weight_t)0, offset0 - in.offset);
+		return true;
+	};
+
+	Decrease dPrep;
+	if(bSamePrep && !decrease(inst, s.prepC, s.prepP, s.prepOffset, dPrep)) {
+		if(bOutput)
+			printf(" --- fixings of the preprocessed instance changed, regions of the previous solve are not reused\n");
+		return false;
+	}
+
+	// solutions of a region contain no removed nodes and all fixed nodes of its decisions, the drop
+	// of its bound is the decrease of the weights these solutions may use
+	vector<int> outMark(inst.n, -1), inMark(inst.n, -1);
+	int mark = 0;
+	auto drop = [&](const vector<pair<int,int>>& steps, const Decrease& d) -> weight_t {
+		mark++;
+		for(auto& step : steps) {
+			if(step.second == BranchPath::EXCLUDE || step.second == BranchPath::OUT)
+				outMark[step.first] = mark;
+			else
+				inMark[step.first] = mark;
+		}
+		weight_t w = d.offset;
+		for(auto& e : d.arcs) {
+			if(outMark[inst.tail[e.first]] != mark && outMark[inst.head[e.first]] != mark) w += e.second;
+		}
+		for(auto& e : d.nodes) {
+			if(inMark[e.first] != mark) w += e.second;
+		}
+		return w;
+	};
+
+	const int nRegions = (int)s.regions.size();
+	vector<weight_t> lbs(nRegions);
+	map<int, vector<int>> regionsOf;
+	vector<int> order;
+	int rest = -1;
+	for(int k = 0; k < nRegions; k++) {
+		const ReoptRegion& region = s.regions[k];
+		int root = -1;
+		for(auto& step : region.path) {
+			if(step.second == BranchPath::ROOT)
+				root = step.first;
+		}
+		lbs[k] = bSamePrep ? region.lb - drop(region.path, dPrep) : region.lb;
+		if(root == -1) {
+			rest = k;
+			continue;
+		}
+		if(regionsOf.find(root) == regionsOf.end())
+			order.push_back(root);
+		regionsOf[root].push_back(k);
+	}
+
+	// The region without root of a symmetric instance consists of the solutions without any of the
+	// roots. It has no reduction tests to reproduce, on a different preprocessed instance its bound
+	// is the sum of the prizes of the excluded roots. Asymmetric instances have no such region, so
+	// the previous roots have to cover the potential roots.
+	weight_t restLb = WMAX;
+	if(rest != -1) {
+		restLb = lbs[rest];
+		if(!bSamePrep) {
+			restLb = inst.offset;
+			for(auto& step : s.regions[rest].path) {
+				const int v = step.first;
+				if(inst.f0[v]) continue;
+				if(inst.f1[v]) {
+					restLb = WMAX;
+					break;
+				}
+				if(regionsOf.find(v) == regionsOf.end()) {
+					if(bOutput)
+						printf(" --- roots of the previous solve changed, its regions are not reused\n");
+					return false;
+				}
+				restLb += inst.p[v];
+			}
+		}
+		if(ub - restLb > params.absgap) {
+			if(bOutput)
+				printf(" --- bound of the remaining roots too weak, regions of the previous solve are not reused\n");
+			return false;
+		}
+	} else if(!bSamePrep) {
+		for(int r : sortedListPotentialRoots()) {
+			if(inst.f0[r] || regionsOf.find(r) != regionsOf.end()) continue;
+			if(bOutput)
+				printf(" --- roots of the previous solve changed, its regions are not reused\n");
+			return false;
+		}
+	}
+
+	// The reduction tests of a root keep an optimal solution of the root instance, but not all
+	// solutions, so the regions of a root only bound the solutions removed by its reductions by
+	// their minimum, lowered by the drop of the root. Roots are processed again if this bound or
+	// the bound of one of their regions is too weak.
+	vector<int> roots;
+	for(int r : order) {
+		const vector<int>& regions = regionsOf[r];
+		if(!bSamePrep) {
+			// solutions of a removed root are solutions of the other regions
+			if(!inst.f0[r])
+				roots.push_back(r);
+			continue;
+		}
+		bool bOpen = false;
+		weight_t minLb = WMAX;
+		for(int k : regions) {
+			bOpen = bOpen || (ub - lbs[k] > params.absgap);
+			minLb = min(minLb, s.regions[k].lb);
+		}
+		vector<pair<int,int>> rootSteps;
+		for(auto& step : s.regions[regions[0]].path) {
+			rootSteps.push_back(step);
+			if(step.second == BranchPath::ROOT) break;
+		}
+		if(bOpen || ub - (minLb - drop(rootSteps, dPrep)) > params.absgap)
+			roots.push_back(r);
+	}
+
+	Timer tRoot(true);
+	recordPrep();
+	bRootsComplete = true;
+	if(!bRecover) {
+		ProgramStats::initRootNodeStats();
+	}
+
+	// closed regions are kept for the next state, those of processed roots only if the reduction
+	// tests of their root yield the same instance
+	if(bRecord) {
+		if(rest != -1)
+			record.regions.push_back(ReoptRegion{min(restLb, ub), s.regions[rest].path});
+		for(int r : order) {
+			if(!bSamePrep || find(roots.begin(), roots.end(), r) != roots.end()) continue;
+			for(int k : regionsOf[r])
+				record.regions.push_back(ReoptRegion{lbs[k], s.regions[k].path});
+		}
+	}
+
+	vector<weight_t> c = inst.c, p = inst.p;
+	vector<flag_t> f0 = inst.f0, f1 = inst.f1, T = inst.T;
+	const weight_t offset = inst.offset;
+
+	int nReopened = 0, nProcessed = 0, nRegionsReopened = 0;
+	for(int r : roots) {
+		const vector<int>& regions = regionsOf[r];
+
+		if(memUsed() > memLimit() || timeUp(tRoot)) {
+			tState = (memUsed() > memLimit()) ? BB_MEMLIMIT : BB_TIMELIMIT;
+			bRootsComplete = false;
+			break;
+		}
+
+		// the root is processed like in processRoots, on the instance without the roots preceding it
+		const auto& rootSteps = s.regions[regions[0]].path;
+		vector<int> fe0;
+		shared_ptr<const BranchPath> rootPath;
+		size_t depth0 = 0;
+		for(; rootSteps[depth0].second == BranchPath::EXCLUDE; depth0++) {
+			if(!inst.f0[rootSteps[depth0].first])
+				fixTerm(inst, rootSteps[depth0].first, fe0);
+			if(bPaths)
+				rootPath = BranchPath::extend(rootPath, rootSteps[depth0].first, BranchPath::EXCLUDE);
+		}
+		if(bPaths)
+			rootPath = BranchPath::extend(rootPath, r, BranchPath::ROOT);
+
+		BBNode* root = new BBNode(&inst, r, fe0);
+		root->path = rootPath;
+		auto it = s.roots.find(r);
+		if(it != s.roots.end())
+			root->duals = it->second.duals;
+		root->updateNodeSize();
+		const NodeState state = process(root);
+		root->state = (int)state;
+		nProcessed++;
+
+		inst.c = c;
+		inst.p = p;
+		inst.f0 = f0;
+		inst.f1 = f1;
+		inst.T = T;
+		inst.offset = offset;
+
+		if(state != BB_BRANCH) {
+			if(state == BB_LEAF)
+				evalLeaf(root);
+			closeRegion(root->path, root->lb);
+			delete root->inst;
+			delete root;
+			continue;
+		}
+		if(!bRecover) {
+			InstSizeData sdata = root->inst->countInstSize();
+			ProgramStats::addRootNodeStats(sdata);
+		}
+		selectBranchVariable(root);
+
+		// regions below a root that is reduced differently are searched again from the root, the
+		// weights of its previous instance are the changes of the previous preprocessed instance
+		const bool bWhole = (regions.size() == 1 && s.regions[regions[0]].path.size() == depth0+1);
+		Decrease dRoot;
+		bool bSame = !bWhole && it != s.roots.end() && it->second.hash == root->rootHash;
+		if(bSame) {
+			vector<weight_t> c0 = s.prepC, p0 = s.prepP;
+			for(auto& e : it->second.c) c0[e.first] = e.second;
+			for(auto& e : it->second.p) p0[e.first] = e.second;
+			bSame = decrease(*root->inst, c0, p0, it->second.offset, dRoot);
+		}
+		if(!bSame) {
+			add(root);
+			nReopened++;
+			nRegionsReopened += (int)regions.size();
+			continue;
+		}
+
+		shared_ptr<const Inst> base(root->inst);
+		for(int k : regions) {
+			const auto& steps = s.regions[k].path;
+			lbs[k] = s.regions[k].lb - drop(steps, dRoot);
+			if(ub - lbs[k] <= params.absgap) {
+				if(bRecord)
+					record.regions.push_back(ReoptRegion{lbs[k], steps});
+				continue;
+			}
+			BBNode* b = new BBNode(new Inst(*base));
+			Inst& binst = *b->inst;
+			b->path = rootPath;
+			for(size_t l = depth0+1; l < steps.size(); l++) {
+				const int v = steps[l].first;
+				const bool bIn = (steps[l].second == BranchPath::IN);
+				if(bPaths)
+					b->path = BranchPath::extend(b->path, v, bIn ? BranchPath::IN : BranchPath::OUT);
+				b->depth++;
+
+				// nodes already decided by reductions are skipped, which only enlarges the region
+				if(binst.f0[v] || binst.f1[v]) continue;
+				if(bIn) {
+					binst.f1[v] = true;
+					binst.T[v] = true;
+					binst.p[v] = WMAX;
+				} else {
+					binst.removeNode(v);
+				}
+				b->v = v;
+				b->bdir = bIn ? 1 : 0;
+			}
+			b->lb = max(lbs[k], root->lb);
+			b->duals = root->duals;
+			b->updateNodeSize();
+			if(params.bbtrail) {
+				b->base = base;
+				b->store();
+			}
+			add(b);
+			nReopened++;
+			nRegionsReopened++;
+		}
+		delete root;
+	}
+
+	timeLim = max(0.0, timeLim-tRoot.elapsed().getSeconds());
+
+	if(!bRecover) {
+		if(tState != BB_MEMLIMIT && tState != BB_TIMELIMIT) {
+			rootlb = PQmin.empty() ? ub : min(ub, PQmin.top().first);
+			bestlb = rootlb;
+		}
+		rootub = ub;
+		rootTime = tRoot.elapsed().getSeconds();
+		nRoots = (int)roots.size();
+		nRootsProcessed = nProcessed;
+		nRootsOpen = (int)PQmin.size();
+
+		if(!PQmin.empty()) {
+			ProgramStats::averageRootNodeStats(nRootsOpen);
+		}
+	}
+
+	if(bOutput) {
+		printf(" --- reoptimization: %d of %d regions of the previous solve reopened, %d of %d roots processed, %d open nodes ( %0.1lf sec. )\n",
+				nRegionsReopened, nRegions, nProcessed, (int)order.size(), nReopened, tRoot.elapsed().getSeconds());
+	}
+	return true;
+}
+
+void BBTree::initSemiBigM()
+{
 	if(inst.r == -1 && params.semiBigM) {
 
 		instM = inst.createRootedBigMCopy();
@@ -966,7 +2624,6 @@ int BBTree::initPrep()
 		bestlb = lbM;
 		rootlb = lbM;
 	}
-	return 0;
 }
 
 bool BBTree::isFeas(Inst& inst, bool bDoNRtest)
@@ -0,0 +1,92 @@
+/**
+ * \file   board.cpp
+ * \brief  incumbent and upper bound shared by the concurrent components of a solve
+ *
+ * \author Martin Luipersbeck
+ * \date   2026-10-17
+ */
+
+#include "board.h"
+#include "timer.h"
+
+BoundBoard::~BoundBoard()
+{
+	const Incumbent* S = head.load();
+	while(S != nullptr) {
+		const Incumbent* prev = S->prev;
+		delete S;
+		S = prev;
+	}
+}
+
+const BoundBoard::Incumbent* BoundBoard::publish(Sol& sol, Inst& inst, bool bMap)
+{
+	if(sol.obj >= ub())
+		return nullptr;
+
+	Incumbent* S = new Incumbent(sol);
+	if(bMap) {
+		S->support = collectSolSupport(sol, inst);
+		S->bMapped = true;
+	}
+	S->time = Timer::total.elapsed().getSeconds();
+
+	// the head only ever improves, the swap fails if a solution was published meanwhile
+	const Incumbent* cur = head.load(memory_order_acquire);
+	do {
+		if(cur != nullptr && cur->sol.obj <= sol.obj) {
+			delete S;
+			return nullptr;
+		}
+		S->prev = cur;
+		S->version = (cur != nullptr) ? cur->version+1 : 1;
+	} while(!head.compare_exchange_weak(cur, S, memory_order_acq_rel, memory_order_acquire));
+
+	// the bound and the version follow the head, readers may see them lag behind
+	atomicMin(bound, sol.obj);
+	atomicMax(ver, S->version);
+	return S;
+}
+
+void BoundBoard::reset(Sol& sol, Inst& inst)
+{
+	Incumbent* S = new Incumbent(sol);
+	S->support = collectSolSupport(sol, inst);
+	S->bMapped = true;
+	S->time = Timer::total.elapsed().getSeconds();
+	S->prev = head.load();
+	S->version = (S->prev != nullptr) ? S->prev->version+1 : 1;
+	head = S;
+	bound = sol.obj;
+	ver = S->version;
+}
+
+void BoundBoard::cutUp(weight_t b)
+{
+	atomicMin(bound, b);
+}
+
+Sol BoundBoard::original(int& version)
+{
+	lock_guard<mutex> lock(mtxOrig);
+	const Incumbent* S = incumbent();
+	if(S != nullptr && S->version != origVersion && S->bMapped) {
+		orig = expandSolSupport(S->support, inst1);
+		origVersion = S->version;
+	}
+	version = (S != nullptr) ? S->version : 0;
+	return orig;
+}
+
+void BoundBoard::reclaim()
+{
+	const Incumbent* S = head.load();
+	if(S == nullptr) return;
+	const Incumbent* prev = S->prev;
+	const_cast<Incumbent*>(S)->prev = nullptr;
+	while(prev != nullptr) {
+		const Incumbent* next = prev->prev;
+		delete prev;
+		prev = next;
+	}
+}
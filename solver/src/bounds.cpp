@@ -11,10 +11,63 @@ using namespace std;
 #include "bounds.h"
 #include "util.h"
 #include "options.h"
+#include "dakernels.h"
 #include <stdlib.h>
+#include <cmath>
 #include <iostream>
 
-template<typename U> weight_t daR(int r, Inst& inst, vector<U>& c, vector<U>& cr, vector<U>& pi, weight_t ub, double eager, Sol* inc, bool heur)
+// buffers of the dual ascent, sized to the largest instance seen and reused by all calls of a thread.
+// Membership in the current component and activity are marked by epochs, so they need no clearing.
+template<typename U>
+class DAWorkspace
+{
+public:
+	vector<int> Q, L, Ltails, S;
+	vector<U> Lcr;
+	vector<unsigned> cut, active;
+	unsigned cutEpoch = 0, activeEpoch = 0;
+
+	PQMin<int,int> PQ;
+	BucketQueue    bucketPQ{0, 0};
+
+	// used for the last component
+	PQMin<U,int> PQ2;
+	vector<U>    dist;
+
+	void resize(int n, int m)
+	{
+		if((int)cut.size() < n) {
+			Q.resize(n);
+			cut.resize(n, 0);
+			active.resize(n, 0);
+		}
+		if((int)L.size() < m) {
+			L.resize(m);
+			Ltails.resize(m);
+			S.resize(m);
+			Lcr.resize(m);
+		}
+		PQ.clear();
+		bucketPQ.clear();
+	}
+
+	unsigned nextCutEpoch()    { return nextEpoch(cutEpoch, cut); }
+	unsigned nextActiveEpoch() { return nextEpoch(activeEpoch, active); }
+
+private:
+	static unsigned nextEpoch(unsigned& epoch, vector<unsigned>& marks)
+	{
+		if(++epoch == 0) {
+			fill(marks.begin(), marks.end(), 0);
+			epoch = 1;
+		}
+		return epoch;
+	}
+};
+
+// dual ascent, the active components are kept in the priority queue PQ
+template<typename U, typename Queue>
+static weight_t daR(int r, Inst& inst, vector<U>& c, vector<U>& cr, vector<U>& pi, weight_t ub, double eager, Sol* inc, bool heur, bool warm, const atomic<weight_t>* ubLive, int iterLim, DAWorkspace<U>& ws, Queue& PQ)
 {
 	weight_t lb = inst.offset;
 	const int n = inst.n, m = inst.m;
@@ -22,38 +75,53 @@ template<typename U> weight_t daR(int r, Inst& inst, vector<U>& c, vector<U>& cr
 	vector<weight_t>& p = inst.p;
 	vector<flag_t>& T = inst.T;
 	
-	int Q[n];
+	int* const Q = ws.Q.data();
 	int qL1 = 0, qL2 = 0;
-	PQMin<int,int> PQ;
-	bool cut[n], active[n];
-
-	for(int i = 0; i < m; i++) {
-		if(inst.fe0[i]) continue;
-		cr[i] = c[i];
+	unsigned* const cut = ws.cut.data();
+	unsigned* const active = ws.active.data();
+	unsigned ce = 0;
+	const unsigned ae = ws.nextActiveEpoch();
+
+	if(!warm) {
+		for(int i = 0; i < m; i++) {
+			if(inst.fe0[i]) continue;
+			cr[i] = c[i];
+		}
 	}
 	
 	for(int i = 0; i < n; i++) {
-		active[i] = false;
-		cut[i] = false;
 		if(!T[i] || i == r) continue;
-		pi[i] = inst.f1[i] ? WMAX : p[i];
+		if(warm) {
+			// the revenue already consumed by the given duals counts towards the bound
+			lb += (inst.f1[i] ? WMAX : p[i]) - pi[i];
+			if(pi[i] <= 0) continue;
+		} else {
+			pi[i] = inst.f1[i] ? WMAX : p[i];
+		}
 		PQ.push(make_pair(1, i));
-		if(inst.f1[i]) active[i] = true;
+		if(inst.f1[i]) active[i] = ae;
 	}
 	
-	active[r] = true;
+	active[r] = ae;
 	if(PQ.size() == 0) {
 		return lb;
 	}
 	
-	int *L = new int[m];
-	int *Ltails = new int[m];
+	// cut arcs L of the current component, their tails and reduced costs. While the component is
+	// augmented the reduced costs are kept in Lcr only, S holds the arcs saturated by the last augmentation
+	int* const L = ws.L.data();
+	int* const Ltails = ws.Ltails.data();
+	U* const Lcr = ws.Lcr.data();
+	int* const S = ws.S.data();
+	const U sat = is_integral<U>::value ? (U)floor(params.dasat) : (U)params.dasat;
+	// parameters are thread-local, read them once outside of the loops
+	const double dasat = params.dasat;
+	const bool daguide = params.daguide, lastcomp = params.lastcomp;
 	
-	int iter = 0;
+	int iter = 0, nAug = 0;
 	int v = -1;
 	bool augmentroot = false;
 
-choose_element:
 	while ( !PQ.empty() ) {
 
 		pair<int,int> entry = PQ.top();
@@ -63,57 +131,81 @@ choose_element:
 		int prio = entry.first;
 		v = entry.second;
 
-		if(params.lastcomp && PQ.empty() && !augmentroot) {
+		if(lastcomp && PQ.empty() && !augmentroot) {
 			augmentroot = true;
 			break;
 		}
 
+		// the component of v only grows while v is augmented, so it is built once and then extended
+		// by the tails of arcs saturated in the previous augmentation
+		bool bNewComponent = true, bDeactivated = false;
+		int cL = 0, nS = 0, vc = 1, deg = 0;
 		do {
-			int cL = 0, vc = 1;
-			int deg = inst.din[v].size();
-			for(int j = 0; j < qL1; j++) {
-				cut[Q[j]] = false;
+			if(bNewComponent) {
+				ce = ws.nextCutEpoch();
+				qL1 = 0;
+				qL2 = 0;
+				cL = 0;
+				vc = 1;
+				deg = inst.din[v].size();
+				Q[qL1++] = v;
+				cut[v] = ce;
+				bNewComponent = false;
+			} else {
+				for(int k = 0; k < nS; k++) {
+					const int u = Ltails[S[k]];
+					if(cut[u] == ce) continue;
+					if ( active[u] == ae ) {
+						bDeactivated = true;
+						goto component_done;
+					}
+
+					Q[qL1++] = u;
+					cut[u] = ce;
+					vc++;
+					deg += inst.din[u].size();
+				}
 			}
-			qL1 = 0;
-			qL2 = 0;
-			Q[qL1++] = v;
-			cut[v] = true;
 
-			// identify component
+			// identify component (only nodes added since the last iteration are scanned)
 			while ( qL2 != qL1 ) {
 				const int w = Q[qL2++];
 				for(int ij : inst.din[w]) {
 					const int u = inst.tail[ij];
 
-					if ( cr[ij] <= params.dasat ) {
-						if(!cut[u]) {
-							if ( active[u] ) {
-								active[v] = false;
-								goto choose_element;
+					if ( cr[ij] <= dasat ) {
+						if(cut[u] != ce) {
+							if ( active[u] == ae ) {
+								bDeactivated = true;
+								goto component_done;
 							}
 
 							Q[qL1++] = u;
-							cut[u] = true;
+							cut[u] = ce;
 							vc++;
 							deg += inst.din[u].size();
 						}
 					} else {
 						L[cL] = ij;
+						Lcr[cL] = cr[ij];
 						Ltails[cL++] = u;
 					}
 				}
 			}
 
+			// remove arcs whose tails joined the component
 			int i = 0, j = 0;
 			while(i < cL) {
-				while(i < cL && cut[Ltails[i]]) {
+				while(i < cL && cut[Ltails[i]] == ce) {
+					cr[L[i]] = Lcr[i];
 					i++;
 				}
 				if(i == cL) break;
-				// here !cut[Ltails[i]] holds
+				// here Ltails[i] is not in the component
 				if(j < i) {
 					Ltails[j] = Ltails[i];
 					L[j] = L[i];
+					Lcr[j] = Lcr[i];
 				}
 				j++;
 				i++;
@@ -122,7 +214,7 @@ choose_element:
 			
 			// compute component priority
 			prio = deg - (vc-1);
-			if(params.daguide && inc != nullptr) {
+			if(daguide && inc != nullptr) {
 				int nSolArcsInCut = 0;
 				for(int i = 0; i < cL; i++) {
 					if(inc->arcs[L[i]]) nSolArcsInCut++;
@@ -137,47 +229,57 @@ choose_element:
 			}
 
 			// perform augmentation
-			U delta = std::numeric_limits<U>::max();
-			for(int i = 0; i < cL; i++) {
-				if ( cr[L[i]] < delta ) delta = cr[L[i]];
-			}
-			delta = min(pi[v], delta);
-
-			for(int i = 0; i < cL; i++)
-				cr[L[i]] -= delta;
+			U delta = min(pi[v], minValue(Lcr, cL));
+			nS = subtractSaturate(Lcr, cL, delta, sat, S);
 			pi[v] -= delta;
 			lb += delta;
-
-			int cnt = 0;
-			for(int i = 0; i < cL; i++) {
-				if(cr[L[i]] <= params.dasat) {
-					deg += inst.din[Ltails[i]].size();
-					vc++;
-					if(inc != nullptr && params.daguide && inc->arcs[L[i]] == 1) cnt++;
-				}
+			nAug++;
+
+			// estimate priority of the grown component
+			int cnt = 0, degNext = deg, vcNext = vc;
+			for(int k = 0; k < nS; k++) {
+				degNext += inst.din[Ltails[S[k]]].size();
+				vcNext++;
+				if(inc != nullptr && daguide && inc->arcs[L[S[k]]] == 1) cnt++;
 			}
 
 			if ( pi[v] <= 0 || lb >= ub) {
 				break;
 			}
 
-			prio = (deg - (vc-1));
+			prio = (degNext - (vcNext-1));
 			if(cnt > 1) prio += cnt * inst.m;
 
 		} while ( prio <= nextpr );
-		
+
+component_done:
+		for(int i = 0; i < cL; i++)
+			cr[L[i]] = Lcr[i];
+
+		// v reached another active component
+		if(bDeactivated) {
+			active[v] = 0;
+			continue;
+		}
+
 		if(pi[v] != 0)
 			PQ.push(make_pair(prio, v));
+		if(ubLive != nullptr)
+			ub = min(ub, ubLive->load(memory_order_relaxed));
 		if(lb >= ub)
 			break;
+		if(iterLim > 0 && nAug >= iterLim)
+			break;
 	}
 	 
 	// compute last component cuts via shortest path
-	if(params.lastcomp && augmentroot && lb < ub) {
+	if(lastcomp && augmentroot && lb < ub) {
 		
 		// dijkstra
-		PQMin<U,int> PQ2;
-		vector<U> dist(inst.n, std::numeric_limits<U>::max());
+		PQMin<U,int>& PQ2 = ws.PQ2;
+		vector<U>& dist = ws.dist;
+		PQ2.clear();
+		dist.assign(inst.n, std::numeric_limits<U>::max());
 		dist[v] = 0;
 		PQ2.push(make_pair(0, v));
 		while ( !PQ2.empty() ) {
@@ -244,7 +346,7 @@ choose_element:
 		}
 		
 		// reduce bigM by minsat -> at least one artificial root arc is saturated
-		if(minSat > params.dasat) {
+		if(minSat > dasat) {
 			weight_t delta = minSat;
 			inst.bigM -= delta;
 			for(int rj : inst.dout[inst.r]) {
@@ -256,12 +358,23 @@ choose_element:
 		}
 	}
 
-	delete[] L;
-	delete[] Ltails;
-
 	return lb;
 }
 
-template weight_t daR<weight_t>(int r, Inst& inst, vector<weight_t>& c, vector<weight_t>& cr, vector<weight_t>& pi, weight_t ub, double rel, Sol* inc, bool heur);
-template weight_t daR<double>(int r, Inst& inst, vector<double>& c, vector<double>& cr, vector<double>& pi, weight_t ub, double rel, Sol* inc, bool heur);
+template<typename U> weight_t daR(int r, Inst& inst, vector<U>& c, vector<U>& cr, vector<U>& pi, weight_t ub, double eager, Sol* inc, bool heur, bool warm, const atomic<weight_t>* ubLive, int iterLim)
+{
+	static thread_local DAWorkspace<U> ws;
+	ws.resize(inst.n, inst.m);
+
+	// priorities are bounded by the number of arcs, unless raised by guiding solutions
+	if(params.dabucket) {
+		ws.bucketPQ.resize(inst.n, inst.m+1);
+		return daR(r, inst, c, cr, pi, ub, eager, inc, heur, warm, ubLive, iterLim, ws, ws.bucketPQ);
+	}
+
+	return daR(r, inst, c, cr, pi, ub, eager, inc, heur, warm, ubLive, iterLim, ws, ws.PQ);
+}
+
+template weight_t daR<weight_t>(int r, Inst& inst, vector<weight_t>& c, vector<weight_t>& cr, vector<weight_t>& pi, weight_t ub, double rel, Sol* inc, bool heur, bool warm, const atomic<weight_t>* ubLive, int iterLim);
+template weight_t daR<double>(int r, Inst& inst, vector<double>& c, vector<double>& cr, vector<double>& pi, weight_t ub, double rel, Sol* inc, bool heur, bool warm, const atomic<weight_t>* ubLive, int iterLim);
 
@@ -0,0 +1,643 @@
+/**
+ * \file   cache.cpp
+ * \brief  binary cache of loaded instances (.stpb files), presolve snapshots and reoptimization states
+ *
+ * \author Martin Luipersbeck
+ * \date   2026-10-17
+ */
+
+#include "cache.h"
+#include "reader.h"
+#include "options.h"
+#include "stats.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <boost/filesystem.hpp>
+
+// The file consists of the header followed by the arrays of the instance, each padded to a multiple
+// of 8 bytes. The source file is identified by its size and modification time.
+static const char     cacheMagic[8] = { 'D', 'A', 'P', 'C', 'S', 'T', 'P', 'B' };
+static const uint32_t cacheVersion  = 1;
+
+struct CacheHeader {
+	char     magic[8];
+	uint32_t version;
+	int32_t  n, m, t, r;
+	uint8_t  isInt, isAsym, isMWCS, hasTransformation;
+	char     type[16];
+	int64_t  precision;
+	int64_t  sourceSize, sourceSec, sourceNsec;
+	int64_t  offset, bigM;
+	int64_t  P, minP, sumC;
+	int64_t  nDin, nDout;
+};
+
+static bool sourceVersion(const char* fn, CacheHeader& h)
+{
+	struct stat st;
+	if(stat(fn, &st) != 0) return false;
+	h.sourceSize = st.st_size;
+	h.sourceSec = st.st_mtim.tv_sec;
+	h.sourceNsec = st.st_mtim.tv_nsec;
+	return true;
+}
+
+static size_t padded(size_t bytes)
+{
+	return (bytes + 7) & ~(size_t)7;
+}
+
+// reads an array of k elements and advances the read position
+template<typename T>
+static bool readArray(const char*& pos, const char* end, vector<T>& v, size_t k)
+{
+	const size_t bytes = k * sizeof(T);
+	if((size_t)(end - pos) < padded(bytes)) return false;
+	v.resize(k);
+	if(bytes > 0) memcpy(v.data(), pos, bytes);
+	pos += padded(bytes);
+	return true;
+}
+
+template<typename T>
+static void writeArray(FILE* fp, const T* a, size_t k)
+{
+	static const char zeros[8] = {};
+	const size_t bytes = k * sizeof(T);
+	fwrite(a, 1, bytes, fp);
+	fwrite(zeros, 1, padded(bytes) - bytes, fp);
+}
+
+string cachePath(const char* fn)
+{
+	return boost::filesystem::path(fn).replace_extension(".stpb").string();
+}
+
+// checks that the adjacency list of each node only contains arcs incident to it (at[a] is the node
+// of arc a), stored at the positions given by at pos
+static bool validLists(const vector<int>& len, const vector<int>& data, const vector<int>& at, const vector<int>& pos)
+{
+	const int m = (int)at.size();
+	size_t e = 0;
+	for(int i = 0; i < (int)len.size(); i++) {
+		if(len[i] < 0 || e + len[i] > data.size()) return false;
+		for(int k = 0; k < len[i]; k++, e++) {
+			const int a = data[e];
+			if(a < 0 || a >= m || at[a] != i || pos[a] != k) return false;
+		}
+	}
+	return e == data.size();
+}
+
+// reads the arrays of an instance described by the header. Files may come from clients of the
+// daemon, so every index is checked before the instance is built.
+static bool readInst(const char*& pos, const char* end, const CacheHeader& h, Inst& inst)
+{
+	if(h.n < 0 || h.m < 0 || h.nDin < 0 || h.nDout < 0 || h.r < -1 || h.r >= h.n) return false;
+	const size_t n = h.n, m = h.m;
+
+	inst.n = h.n;
+	inst.m = h.m;
+	inst.t = h.t;
+	inst.r = h.r;
+	inst.offset = h.offset;
+	inst.bigM = h.bigM;
+	inst.isInt = h.isInt;
+	inst.isAsym = h.isAsym;
+	inst.isMWCS = h.isMWCS;
+
+	vector<int> dinLen, dinData, doutLen, doutData;
+	bool ok = readArray(pos, end, inst.tail, m)
+	       && readArray(pos, end, inst.head, m)
+	       && readArray(pos, end, inst.opposite, m)
+	       && readArray(pos, end, inst.pin, m)
+	       && readArray(pos, end, inst.pout, m)
+	       && readArray(pos, end, inst.c, m)
+	       && readArray(pos, end, inst.fe0, m)
+	       && readArray(pos, end, inst.p, n)
+	       && readArray(pos, end, inst.T, n)
+	       && readArray(pos, end, inst.f0, n)
+	       && readArray(pos, end, inst.f1, n)
+	       && readArray(pos, end, dinLen, n)
+	       && readArray(pos, end, dinData, h.nDin)
+	       && readArray(pos, end, doutLen, n)
+	       && readArray(pos, end, doutData, h.nDout);
+	if(!ok) return false;
+
+	for(size_t ij = 0; ij < m; ij++) {
+		if(inst.tail[ij] < 0 || inst.tail[ij] >= h.n || inst.head[ij] < 0 || inst.head[ij] >= h.n) return false;
+		const int ji = inst.opposite[ij];
+		if(ji != -1 && (ji < 0 || ji >= h.m || inst.opposite[ji] != (int)ij)) return false;
+	}
+	if(!validLists(dinLen, dinData, inst.head, inst.pin) || !validLists(doutLen, doutData, inst.tail, inst.pout)) return false;
+
+	inst.din.assignCompact(h.n, dinLen.data(), dinData.data());
+	inst.dout.assignCompact(h.n, doutLen.data(), doutData.data());
+	return true;
+}
+
+// fills the instance fields of the header, din and dout are compacted copies of the adjacency lists
+static void instHeader(CacheHeader& h, const Inst& inst, const Adjacency& din, const Adjacency& dout)
+{
+	memcpy(h.magic, cacheMagic, sizeof(cacheMagic));
+	h.version = cacheVersion;
+	// headers are zeroed before, the type stays terminated
+	memcpy(h.type, params.type.c_str(), min(params.type.size(), sizeof(h.type)-1));
+	h.precision = params.precision;
+	h.n = inst.n;
+	h.m = inst.m;
+	h.t = inst.t;
+	h.r = inst.r;
+	h.offset = inst.offset;
+	h.bigM = inst.bigM;
+	h.isInt = inst.isInt;
+	h.isAsym = inst.isAsym;
+	h.isMWCS = inst.isMWCS;
+	if(inst.transformation != nullptr) {
+		h.hasTransformation = 1;
+		h.P = inst.transformation->P;
+		h.minP = inst.transformation->minP;
+		h.sumC = inst.transformation->sumC;
+	}
+	h.nDin = din.elements().size();
+	h.nDout = dout.elements().size();
+}
+
+static void writeInst(FILE* fp, const Inst& inst, const Adjacency& din, const Adjacency& dout)
+{
+	writeArray(fp, inst.tail.data(), inst.m);
+	writeArray(fp, inst.head.data(), inst.m);
+	writeArray(fp, inst.opposite.data(), inst.m);
+	writeArray(fp, inst.pin.data(), inst.m);
+	writeArray(fp, inst.pout.data(), inst.m);
+	writeArray(fp, inst.c.data(), inst.m);
+	writeArray(fp, inst.fe0.data(), inst.m);
+	writeArray(fp, inst.p.data(), inst.n);
+	writeArray(fp, inst.T.data(), inst.n);
+	writeArray(fp, inst.f0.data(), inst.n);
+	writeArray(fp, inst.f1.data(), inst.n);
+	writeArray(fp, din.lengths().data(), inst.n);
+	writeArray(fp, din.elements().data(), din.elements().size());
+	writeArray(fp, dout.lengths().data(), inst.n);
+	writeArray(fp, dout.elements().data(), dout.elements().size());
+}
+
+// opens a temporary file next to path, which is renamed to path by closeTemp, so concurrent runs
+// never see a partially written file
+static FILE* openTemp(const string& path, string& tmpPath)
+{
+	tmpPath = path + "." + to_string(getpid());
+	FILE* fp = fopen(tmpPath.c_str(), "wb");
+	if(fp == NULL) {
+		fprintf(stderr, "warning: could not write file %s\n", path.c_str());
+	}
+	return fp;
+}
+
+static void closeTemp(FILE* fp, const string& path, const string& tmpPath)
+{
+	const bool ok = (ferror(fp) == 0);
+	if(fclose(fp) != 0 || !ok || rename(tmpPath.c_str(), path.c_str()) != 0) {
+		fprintf(stderr, "warning: could not write file %s\n", path.c_str());
+		remove(tmpPath.c_str());
+	}
+}
+
+bool isCacheData(const char* data, size_t size)
+{
+	return size >= sizeof(cacheMagic) && memcmp(data, cacheMagic, sizeof(cacheMagic)) == 0;
+}
+
+bool loadCache(const char* fn, Inst& inst)
+{
+	const string path = cachePath(fn);
+	MappedFile file(path.c_str());
+	if(!file.isOpen() || file.size() < sizeof(CacheHeader)) return false;
+
+	CacheHeader h, src;
+	memcpy(&h, file.data(), sizeof(CacheHeader));
+	if(!sourceVersion(fn, src) || h.sourceSize != src.sourceSize || h.sourceSec != src.sourceSec || h.sourceNsec != src.sourceNsec) return false;
+
+	return loadCacheData(file.data(), file.size(), inst);
+}
+
+bool loadCacheData(const char* data, size_t size, Inst& inst)
+{
+	if(size < sizeof(CacheHeader)) return false;
+
+	CacheHeader h;
+	memcpy(&h, data, sizeof(CacheHeader));
+	if(memcmp(h.magic, cacheMagic, sizeof(cacheMagic)) != 0 || h.version != cacheVersion) return false;
+	if(strncmp(h.type, params.type.c_str(), sizeof(h.type)) != 0 || h.precision != params.precision) return false;
+
+	const char* pos = data + sizeof(CacheHeader);
+	const char* end = data + size;
+
+	Inst tmp;
+	if(!readInst(pos, end, h, tmp) || pos != end) return false;
+
+	if(h.hasTransformation) {
+		tmp.transformation = new Transformation();
+		tmp.transformation->P = h.P;
+		tmp.transformation->minP = h.minP;
+		tmp.transformation->sumC = h.sumC;
+	}
+
+	inst = std::move(tmp);
+	return true;
+}
+
+void writeCache(const char* fn, const Inst& inst)
+{
+	// copies of the adjacency lists are compacted
+	const Adjacency din = inst.din, dout = inst.dout;
+
+	CacheHeader h;
+	memset(&h, 0, sizeof(h));
+	if(!sourceVersion(fn, h)) return;
+	instHeader(h, inst, din, dout);
+
+	string tmpPath;
+	const string path = cachePath(fn);
+	FILE* fp = openTemp(path, tmpPath);
+	if(fp == NULL) return;
+
+	fwrite(&h, sizeof(h), 1, fp);
+	writeInst(fp, inst, din, dout);
+	closeTemp(fp, path, tmpPath);
+}
+
+// A presolve snapshot consists of its header, the preprocessed instance in the format of the
+// cache files and the backmapping (list lengths followed by their concatenated elements).
+static const char     presolvedMagic[8] = { 'D', 'A', 'P', 'C', 'P', 'R', 'E', 'P' };
+static const uint32_t presolvedVersion  = 1;
+
+struct PresolvedHeader {
+	char     magic[8];
+	uint32_t version;
+	uint64_t fingerprint;
+	int32_t  d1, d2, ma, ms, ss, lc, nr, boundbased;
+	int64_t  nBmna, nBmaa;
+	CacheHeader inst;
+};
+
+// hash of the data of an instance that preprocessing depends on
+static uint64_t fingerprint(const Inst& inst)
+{
+	uint64_t h = 1469598103934665603ULL;
+	auto mix = [&h](int64_t x) { h = (h ^ (uint64_t)x) * 1099511628211ULL; };
+	mix(inst.n); mix(inst.m); mix(inst.r); mix(inst.offset); mix(inst.bigM);
+	mix(inst.isInt); mix(inst.isAsym); mix(inst.isMWCS);
+	for(int ij = 0; ij < inst.m; ij++) {
+		mix(inst.tail[ij]); mix(inst.head[ij]); mix(inst.c[ij]);
+	}
+	for(int i = 0; i < inst.n; i++) {
+		mix(inst.p[i]); mix(inst.f0[i]); mix(inst.f1[i]);
+	}
+	return h;
+}
+
+static bool readLists(const char*& pos, const char* end, vector<vector<int>>& lists, size_t k, size_t nElements)
+{
+	vector<int> len, data;
+	if(!readArray(pos, end, len, k) || !readArray(pos, end, data, nElements)) return false;
+
+	lists.resize(k);
+	size_t e = 0;
+	for(size_t i = 0; i < k; i++) {
+		if(len[i] < 0 || e + len[i] > nElements) return false;
+		lists[i].assign(data.begin() + e, data.begin() + e + len[i]);
+		e += len[i];
+	}
+	return e == nElements;
+}
+
+static void writeLists(FILE* fp, const vector<vector<int>>& lists, size_t k)
+{
+	vector<int> len, data;
+	for(size_t i = 0; i < k; i++) {
+		len.push_back(lists[i].size());
+		data.insert(data.end(), lists[i].begin(), lists[i].end());
+	}
+	writeArray(fp, len.data(), len.size());
+	writeArray(fp, data.data(), data.size());
+}
+
+static size_t countElements(const vector<vector<int>>& lists, size_t k)
+{
+	size_t e = 0;
+	for(size_t i = 0; i < k; i++) e += lists[i].size();
+	return e;
+}
+
+bool loadPresolved(const char* fn, const Inst& inst1, Inst& inst)
+{
+	MappedFile file(fn);
+	if(!file.isOpen() || file.size() < sizeof(PresolvedHeader)) return false;
+
+	PresolvedHeader h;
+	memcpy(&h, file.data(), sizeof(PresolvedHeader));
+	if(memcmp(h.magic, presolvedMagic, sizeof(presolvedMagic)) != 0 || h.version != presolvedVersion) return false;
+	if(h.inst.version != cacheVersion || h.fingerprint != fingerprint(inst1)) return false;
+	if(h.nBmna < 0 || h.nBmaa < 0) return false;
+	if(h.inst.n != inst1.n || h.inst.m != inst1.m) return false;
+
+	const char* pos = file.data() + sizeof(PresolvedHeader);
+	const char* end = file.data() + file.size();
+
+	Inst tmp;
+	bool ok = readInst(pos, end, h.inst, tmp)
+	       && readLists(pos, end, tmp.bmna, h.inst.n, h.nBmna)
+	       && readLists(pos, end, tmp.bmaa, h.inst.m, h.nBmaa);
+	if(!ok || pos != end) return false;
+
+	// the backmapping refers to arcs of the original instance
+	for(auto* lists : { &tmp.bmna, &tmp.bmaa }) {
+		for(auto& l : *lists) {
+			for(int a : l) if(a < 0 || a >= inst1.m) return false;
+		}
+	}
+
+	tmp.inst1 = inst.inst1;
+	tmp.transformation = inst.transformation;
+	inst = std::move(tmp);
+
+	stats.d1 = h.d1;
+	stats.d2 = h.d2;
+	stats.ma = h.ma;
+	stats.ms = h.ms;
+	stats.ss = h.ss;
+	stats.lc = h.lc;
+	stats.nr = h.nr;
+	stats.boundbased = h.boundbased;
+	return true;
+}
+
+void writePresolved(const char* fn, const Inst& inst1, const Inst& inst)
+{
+	const Adjacency din = inst.din, dout = inst.dout;
+
+	PresolvedHeader h;
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, presolvedMagic, sizeof(presolvedMagic));
+	h.version = presolvedVersion;
+	h.fingerprint = fingerprint(inst1);
+	h.d1 = stats.d1;
+	h.d2 = stats.d2;
+	h.ma = stats.ma;
+	h.ms = stats.ms;
+	h.ss = stats.ss;
+	h.lc = stats.lc;
+	h.nr = stats.nr;
+	h.boundbased = stats.boundbased;
+	h.nBmna = countElements(inst.bmna, inst.n);
+	h.nBmaa = countElements(inst.bmaa, inst.m);
+	instHeader(h.inst, inst, din, dout);
+
+	string tmpPath;
+	const string path = fn;
+	FILE* fp = openTemp(path, tmpPath);
+	if(fp == NULL) return;
+
+	fwrite(&h, sizeof(h), 1, fp);
+	writeInst(fp, inst, din, dout);
+	writeLists(fp, inst.bmna, inst.n);
+	writeLists(fp, inst.bmaa, inst.m);
+	closeTemp(fp, path, tmpPath);
+}
+
+// A reoptimization state consists of its header, the incumbent, the weights of the preprocessed
+// instance, the regions (bounds, numbers of decisions and the concatenated decisions) and the roots
+// (structure hashes and dual solutions given by bounds, list lengths and concatenated consumptions,
+// roots without dual solution have arcMoves -1, and the weights of the root instances given by offsets,
+// list lengths and concatenated changes), followed by the branching priorities of checkpoints.
+static const char     stateMagic[8] = { 'D', 'A', 'P', 'C', 'S', 'T', 'A', 'T' };
+static const uint32_t stateVersion  = 2;
+
+struct StateHeader {
+	char     magic[8];
+	uint32_t version;
+	int32_t  complete;
+	char     type[16];
+	int64_t  precision;
+	uint64_t instHash, prepHash;
+	int32_t  n1, m1, n, m;
+	int32_t  solRoot, nPrio;
+	int64_t  prepOffset;
+	int64_t  nRegions, nSteps, nRoots, nDualArcs, nDualNodes, nRootArcs, nRootNodes;
+};
+
+// splits the concatenated pairs into lists of the given lengths
+template<typename T>
+static bool splitLists(const vector<int>& len, const vector<int>& first, const vector<T>& second, vector<vector<pair<int,T>>>& lists)
+{
+	lists.resize(len.size());
+	size_t e = 0;
+	for(size_t k = 0; k < len.size(); k++) {
+		if(len[k] < 0 || e + len[k] > first.size()) return false;
+		for(int l = 0; l < len[k]; l++, e++) {
+			lists[k].push_back(make_pair(first[e], second[e]));
+		}
+	}
+	return e == first.size();
+}
+
+bool loadReoptState(const char* fn, ReoptState& s)
+{
+	MappedFile file(fn);
+	if(!file.isOpen() || file.size() < sizeof(StateHeader)) return false;
+
+	StateHeader h;
+	memcpy(&h, file.data(), sizeof(StateHeader));
+	if(memcmp(h.magic, stateMagic, sizeof(stateMagic)) != 0 || h.version != stateVersion) return false;
+	if(strncmp(h.type, params.type.c_str(), sizeof(h.type)) != 0 || h.precision != params.precision) return false;
+	if(h.n1 < 0 || h.m1 < 0 || h.n < 0 || h.m < 0 || (h.nPrio != 0 && h.nPrio != h.n) || h.nRegions < 0 || h.nSteps < 0 || h.nRoots < 0 || h.nDualArcs < 0 || h.nDualNodes < 0 || h.nRootArcs < 0 || h.nRootNodes < 0) return false;
+	if(h.solRoot < -1 || h.solRoot >= h.n1) return false;
+
+	const char* pos = file.data() + sizeof(StateHeader);
+	const char* end = file.data() + file.size();
+
+	ReoptState tmp;
+	vector<weight_t> regionLb, rootLb, arcVal, nodeVal, rootOffset, rootArcVal, rootNodeVal;
+	vector<int> regionLen, stepV, stepKind, roots, arcMoves, arcLen, nodeLen, arcIdx, nodeIdx;
+	vector<int> rootArcLen, rootNodeLen, rootArcIdx, rootNodeIdx;
+	vector<uint64_t> rootHash;
+	bool ok = readArray(pos, end, tmp.solNodes, h.n1)
+	       && readArray(pos, end, tmp.solArcs, h.m1)
+	       && readArray(pos, end, tmp.prepC, h.m)
+	       && readArray(pos, end, tmp.prepP, h.n)
+	       && readArray(pos, end, regionLb, h.nRegions)
+	       && readArray(pos, end, regionLen, h.nRegions)
+	       && readArray(pos, end, stepV, h.nSteps)
+	       && readArray(pos, end, stepKind, h.nSteps)
+	       && readArray(pos, end, roots, h.nRoots)
+	       && readArray(pos, end, rootHash, h.nRoots)
+	       && readArray(pos, end, rootLb, h.nRoots)
+	       && readArray(pos, end, arcMoves, h.nRoots)
+	       && readArray(pos, end, arcLen, h.nRoots)
+	       && readArray(pos, end, nodeLen, h.nRoots)
+	       && readArray(pos, end, arcIdx, h.nDualArcs)
+	       && readArray(pos, end, arcVal, h.nDualArcs)
+	       && readArray(pos, end, nodeIdx, h.nDualNodes)
+	       && readArray(pos, end, nodeVal, h.nDualNodes)
+	       && readArray(pos, end, rootOffset, h.nRoots)
+	       && readArray(pos, end, rootArcLen, h.nRoots)
+	       && readArray(pos, end, rootNodeLen, h.nRoots)
+	       && readArray(pos, end, rootArcIdx, h.nRootArcs)
+	       && readArray(pos, end, rootArcVal, h.nRootArcs)
+	       && readArray(pos, end, rootNodeIdx, h.nRootNodes)
+	       && readArray(pos, end, rootNodeVal, h.nRootNodes)
+	       && readArray(pos, end, tmp.prio, h.nPrio);
+	if(!ok || pos != end) return false;
+
+	for(size_t e = 0; e < stepV.size(); e++) {
+		if(stepV[e] < 0 || stepV[e] >= h.n || stepKind[e] < BranchPath::EXCLUDE || stepKind[e] > BranchPath::IN) return false;
+	}
+	vector<vector<pair<int,int>>> paths;
+	vector<vector<pair<int,weight_t>>> arcs, nodes, rootArcs, rootNodes;
+	if(!splitLists(regionLen, stepV, stepKind, paths) || !splitLists(arcLen, arcIdx, arcVal, arcs) || !splitLists(nodeLen, nodeIdx, nodeVal, nodes)) return false;
+	if(!splitLists(rootArcLen, rootArcIdx, rootArcVal, rootArcs) || !splitLists(rootNodeLen, rootNodeIdx, rootNodeVal, rootNodes)) return false;
+
+	for(size_t k = 0; k < paths.size(); k++) {
+		tmp.regions.push_back(ReoptRegion{regionLb[k], paths[k]});
+	}
+	for(size_t k = 0; k < roots.size(); k++) {
+		if(roots[k] < 0 || roots[k] >= h.n) return false;
+		for(auto& e : arcs[k])  if(e.first < 0 || e.first >= h.m) return false;
+		for(auto& e : nodes[k]) if(e.first < 0 || e.first >= h.n) return false;
+		for(auto& e : rootArcs[k])  if(e.first < 0 || e.first >= h.m) return false;
+		for(auto& e : rootNodes[k]) if(e.first < 0 || e.first >= h.n) return false;
+
+		ReoptRoot& root = tmp.roots[roots[k]];
+		root.hash = rootHash[k];
+		root.c = rootArcs[k];
+		root.p = rootNodes[k];
+		root.offset = rootOffset[k];
+		if(arcMoves[k] == -1) continue;
+		auto duals = make_shared<DualState>();
+		duals->arcs = arcs[k];
+		duals->nodes = nodes[k];
+		duals->lb = rootLb[k];
+		duals->arcMoves = arcMoves[k];
+		duals->structure = rootHash[k];
+		root.duals = duals;
+	}
+
+	tmp.instHash = h.instHash;
+	tmp.solRoot = h.solRoot;
+	tmp.prepHash = h.prepHash;
+	tmp.prepOffset = h.prepOffset;
+	tmp.complete = (h.complete != 0);
+	s = std::move(tmp);
+	return true;
+}
+
+void writeReoptState(const char* fn, const ReoptState& s)
+{
+	vector<weight_t> regionLb, rootLb, arcVal, nodeVal, rootOffset, rootArcVal, rootNodeVal;
+	vector<int> regionLen, stepV, stepKind, roots, arcMoves, arcLen, nodeLen, arcIdx, nodeIdx;
+	vector<int> rootArcLen, rootNodeLen, rootArcIdx, rootNodeIdx;
+	vector<uint64_t> rootHash;
+	for(auto& region : s.regions) {
+		regionLb.push_back(region.lb);
+		regionLen.push_back(region.path.size());
+		for(auto& step : region.path) {
+			stepV.push_back(step.first);
+			stepKind.push_back(step.second);
+		}
+	}
+	for(auto& e : s.roots) {
+		DualState duals;
+		duals.lb = 0;
+		duals.arcMoves = -1;
+		if(e.second.duals != nullptr) duals = *e.second.duals;
+		roots.push_back(e.first);
+		rootHash.push_back(e.second.hash);
+		rootLb.push_back(duals.lb);
+		arcMoves.push_back(duals.arcMoves);
+		arcLen.push_back(duals.arcs.size());
+		nodeLen.push_back(duals.nodes.size());
+		for(auto& a : duals.arcs) {
+			arcIdx.push_back(a.first);
+			arcVal.push_back(a.second);
+		}
+		for(auto& v : duals.nodes) {
+			nodeIdx.push_back(v.first);
+			nodeVal.push_back(v.second);
+		}
+		rootOffset.push_back(e.second.offset);
+		rootArcLen.push_back(e.second.c.size());
+		rootNodeLen.push_back(e.second.p.size());
+		for(auto& a : e.second.c) {
+			rootArcIdx.push_back(a.first);
+			rootArcVal.push_back(a.second);
+		}
+		for(auto& v : e.second.p) {
+			rootNodeIdx.push_back(v.first);
+			rootNodeVal.push_back(v.second);
+		}
+	}
+
+	StateHeader h;
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, stateMagic, sizeof(stateMagic));
+	h.version = stateVersion;
+	h.complete = s.complete;
+	// headers are zeroed before, the type stays terminated
+	memcpy(h.type, params.type.c_str(), min(params.type.size(), sizeof(h.type)-1));
+	h.precision = params.precision;
+	h.instHash = s.instHash;
+	h.prepHash = s.prepHash;
+	h.n1 = s.solNodes.size();
+	h.m1 = s.solArcs.size();
+	h.n = s.prepP.size();
+	h.m = s.prepC.size();
+	h.solRoot = s.solRoot;
+	h.nPrio = s.prio.size();
+	h.prepOffset = s.prepOffset;
+	h.nRegions = regionLb.size();
+	h.nSteps = stepV.size();
+	h.nRoots = roots.size();
+	h.nDualArcs = arcIdx.size();
+	h.nDualNodes = nodeIdx.size();
+	h.nRootArcs = rootArcIdx.size();
+	h.nRootNodes = rootNodeIdx.size();
+
+	string tmpPath;
+	const string path = fn;
+	FILE* fp = openTemp(path, tmpPath);
+	if(fp == NULL) return;
+
+	fwrite(&h, sizeof(h), 1, fp);
+	writeArray(fp, s.solNodes.data(), s.solNodes.size());
+	writeArray(fp, s.solArcs.data(), s.solArcs.size());
+	writeArray(fp, s.prepC.data(), s.prepC.size());
+	writeArray(fp, s.prepP.data(), s.prepP.size());
+	writeArray(fp, regionLb.data(), regionLb.size());
+	writeArray(fp, regionLen.data(), regionLen.size());
+	writeArray(fp, stepV.data(), stepV.size());
+	writeArray(fp, stepKind.data(), stepKind.size());
+	writeArray(fp, roots.data(), roots.size());
+	writeArray(fp, rootHash.data(), rootHash.size());
+	writeArray(fp, rootLb.data(), rootLb.size());
+	writeArray(fp, arcMoves.data(), arcMoves.size());
+	writeArray(fp, arcLen.data(), arcLen.size());
+	writeArray(fp, nodeLen.data(), nodeLen.size());
+	writeArray(fp, arcIdx.data(), arcIdx.size());
+	writeArray(fp, arcVal.data(), arcVal.size());
+	writeArray(fp, nodeIdx.data(), nodeIdx.size());
+	writeArray(fp, nodeVal.data(), nodeVal.size());
+	writeArray(fp, rootOffset.data(), rootOffset.size());
+	writeArray(fp, rootArcLen.data(), rootArcLen.size());
+	writeArray(fp, rootNodeLen.data(), rootNodeLen.size());
+	writeArray(fp, rootArcIdx.data(), rootArcIdx.size());
+	writeArray(fp, rootArcVal.data(), rootArcVal.size());
+	writeArray(fp, rootNodeIdx.data(), rootNodeIdx.size());
+	writeArray(fp, rootNodeVal.data(), rootNodeVal.size());
+	writeArray(fp, s.prio.data(), s.prio.size());
+	closeTemp(fp, path, tmpPath);
+}
@@ -0,0 +1,208 @@
+/**
+ * \file   dakernels.cpp
+ * \brief  vectorized kernels of the dual ascent augmentation
+ *
+ * \author Martin Luipersbeck
+ * \date   2026-10-17
+ */
+
+#include "dakernels.h"
+#include "options.h"
+
+#include <immintrin.h>
+
+using namespace std;
+
+enum SimdLevel { SIMD_NONE, SIMD_AVX2, SIMD_AVX512 };
+
+static SimdLevel detectSimdLevel()
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx512f")) return SIMD_AVX512;
+	if(__builtin_cpu_supports("avx2"))    return SIMD_AVX2;
+#endif
+	return SIMD_NONE;
+}
+
+static SimdLevel simdLevel()
+{
+	static const SimdLevel level = detectSimdLevel();
+	return params.dasimd ? level : SIMD_NONE;
+}
+
+// scalar versions
+
+template<typename U>
+static U minScalar(const U* a, int n)
+{
+	U m = numeric_limits<U>::max();
+	for(int i = 0; i < n; i++) {
+		if(a[i] < m) m = a[i];
+	}
+	return m;
+}
+
+template<typename U>
+static int subtractSaturateScalar(U* a, int i, int n, U delta, U sat, int* s, int k)
+{
+	for(; i < n; i++) {
+		a[i] -= delta;
+		if(a[i] <= sat) s[k++] = i;
+	}
+	return k;
+}
+
+static inline int maskToPositions(unsigned mask, int i, int* s, int k)
+{
+	while(mask != 0) {
+		s[k++] = i + __builtin_ctz(mask);
+		mask &= mask-1;
+	}
+	return k;
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+
+// AVX2 versions
+
+__attribute__((target("avx2")))
+static weight_t minAVX2(const weight_t* a, int n)
+{
+	__m256i vmin = _mm256_set1_epi64x(numeric_limits<weight_t>::max());
+	int i = 0;
+	for(; i+4 <= n; i += 4) {
+		const __m256i x = _mm256_loadu_si256((const __m256i*)(a+i));
+		vmin = _mm256_blendv_epi8(vmin, x, _mm256_cmpgt_epi64(vmin, x));
+	}
+	alignas(32) weight_t m[4];
+	_mm256_store_si256((__m256i*)m, vmin);
+	return min(min(min(m[0], m[1]), min(m[2], m[3])), minScalar(a+i, n-i));
+}
+
+__attribute__((target("avx2")))
+static double minAVX2(const double* a, int n)
+{
+	__m256d vmin = _mm256_set1_pd(numeric_limits<double>::max());
+	int i = 0;
+	for(; i+4 <= n; i += 4) {
+		vmin = _mm256_min_pd(vmin, _mm256_loadu_pd(a+i));
+	}
+	alignas(32) double m[4];
+	_mm256_store_pd(m, vmin);
+	return min(min(min(m[0], m[1]), min(m[2], m[3])), minScalar(a+i, n-i));
+}
+
+__attribute__((target("avx2")))
+static int subtractSaturateAVX2(weight_t* a, int n, weight_t delta, weight_t sat, int* s)
+{
+	const __m256i vdelta = _mm256_set1_epi64x(delta), vsat = _mm256_set1_epi64x(sat);
+	int i = 0, k = 0;
+	for(; i+4 <= n; i += 4) {
+		const __m256i x = _mm256_sub_epi64(_mm256_loadu_si256((const __m256i*)(a+i)), vdelta);
+		_mm256_storeu_si256((__m256i*)(a+i), x);
+		const unsigned unsat = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(x, vsat)));
+		k = maskToPositions(~unsat & 0xF, i, s, k);
+	}
+	return subtractSaturateScalar(a, i, n, delta, sat, s, k);
+}
+
+__attribute__((target("avx2")))
+static int subtractSaturateAVX2(double* a, int n, double delta, double sat, int* s)
+{
+	const __m256d vdelta = _mm256_set1_pd(delta), vsat = _mm256_set1_pd(sat);
+	int i = 0, k = 0;
+	for(; i+4 <= n; i += 4) {
+		const __m256d x = _mm256_sub_pd(_mm256_loadu_pd(a+i), vdelta);
+		_mm256_storeu_pd(a+i, x);
+		k = maskToPositions(_mm256_movemask_pd(_mm256_cmp_pd(x, vsat, _CMP_LE_OQ)), i, s, k);
+	}
+	return subtractSaturateScalar(a, i, n, delta, sat, s, k);
+}
+
+// AVX-512 versions
+
+__attribute__((target("avx512f")))
+static weight_t minAVX512(const weight_t* a, int n)
+{
+	__m512i vmin = _mm512_set1_epi64(numeric_limits<weight_t>::max());
+	int i = 0;
+	for(; i+8 <= n; i += 8) {
+		vmin = _mm512_min_epi64(vmin, _mm512_loadu_si512(a+i));
+	}
+	return min((weight_t)_mm512_reduce_min_epi64(vmin), minScalar(a+i, n-i));
+}
+
+__attribute__((target("avx512f")))
+static double minAVX512(const double* a, int n)
+{
+	__m512d vmin = _mm512_set1_pd(numeric_limits<double>::max());
+	int i = 0;
+	for(; i+8 <= n; i += 8) {
+		vmin = _mm512_min_pd(vmin, _mm512_loadu_pd(a+i));
+	}
+	return min(_mm512_reduce_min_pd(vmin), minScalar(a+i, n-i));
+}
+
+__attribute__((target("avx512f")))
+static int subtractSaturateAVX512(weight_t* a, int n, weight_t delta, weight_t sat, int* s)
+{
+	const __m512i vdelta = _mm512_set1_epi64(delta), vsat = _mm512_set1_epi64(sat);
+	int i = 0, k = 0;
+	for(; i+8 <= n; i += 8) {
+		const __m512i x = _mm512_sub_epi64(_mm512_loadu_si512(a+i), vdelta);
+		_mm512_storeu_si512(a+i, x);
+		k = maskToPositions(_mm512_cmple_epi64_mask(x, vsat), i, s, k);
+	}
+	return subtractSaturateScalar(a, i, n, delta, sat, s, k);
+}
+
+__attribute__((target("avx512f")))
+static int subtractSaturateAVX512(double* a, int n, double delta, double sat, int* s)
+{
+	const __m512d vdelta = _mm512_set1_pd(delta), vsat = _mm512_set1_pd(sat);
+	int i = 0, k = 0;
+	for(; i+8 <= n; i += 8) {
+		const __m512d x = _mm512_sub_pd(_mm512_loadu_pd(a+i), vdelta);
+		_mm512_storeu_pd(a+i, x);
+		k = maskToPositions(_mm512_cmp_pd_mask(x, vsat, _CMP_LE_OQ), i, s, k);
+	}
+	return subtractSaturateScalar(a, i, n, delta, sat, s, k);
+}
+
+template<typename U> U minValue(const U* a, int n)
+{
+	switch(simdLevel()) {
+		case SIMD_AVX512: return minAVX512(a, n);
+		case SIMD_AVX2:   return minAVX2(a, n);
+		default:          return minScalar(a, n);
+	}
+}
+
+template<typename U> int subtractSaturate(U* a, int n, U delta, U sat, int* s)
+{
+	switch(simdLevel()) {
+		case SIMD_AVX512: return subtractSaturateAVX512(a, n, delta, sat, s);
+		case SIMD_AVX2:   return subtractSaturateAVX2(a, n, delta, sat, s);
+		default:          return subtractSaturateScalar(a, 0, n, delta, sat, s, 0);
+	}
+}
+
+#else
+
+template<typename U> U minValue(const U* a, int n)
+{
+	return minScalar(a, n);
+}
+
+template<typename U> int subtractSaturate(U* a, int n, U delta, U sat, int* s)
+{
+	return subtractSaturateScalar(a, 0, n, delta, sat, s, 0);
+}
+
+#endif
+
+template weight_t minValue<weight_t>(const weight_t* a, int n);
+template double   minValue<double>(const double* a, int n);
+template int subtractSaturate<weight_t>(weight_t* a, int n, weight_t delta, weight_t sat, int* s);
+template int subtractSaturate<double>(double* a, int n, double delta, double sat, int* s);
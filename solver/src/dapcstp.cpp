@@ -0,0 +1,282 @@
+/**
+ * \file   dapcstp.cpp
+ * \brief  library interface of the solver
+ *
+ * \author Martin Luipersbeck
+ * \date   2026-10-17
+ */
+
+#include "dapcstp.h"
+#include "options.h"
+#include "stats.h"
+#include "timer.h"
+#include "util.h"
+#include "bbtree.h"
+
+#include <math.h>
+
+namespace dapcstp {
+
+// parameters, statistics and timer of the calling thread are replaced for the duration of a solve, which
+// is registered for the memory limit (see ProcStatus::share)
+class SolveContext
+{
+public:
+	SolveContext() : savedParams(params), savedStats(stats)
+	{
+		savedTotal.assign(Timer::total);
+		stats = ProgramStats::Stats();
+		Timer::total.start();
+	}
+
+	~SolveContext()
+	{
+		params = savedParams;
+		stats = savedStats;
+		Timer::total.assign(savedTotal);
+	}
+
+private:
+	ProgramOptions::Parameters savedParams;
+	ProgramStats::Stats savedStats;
+	Timer savedTotal;
+	ProcStatus::SolveGuard guard;
+};
+
+static void parseOptions(const vector<string>& options)
+{
+	vector<string> args = { PROGRAM_NAME };
+	args.insert(args.end(), options.begin(), options.end());
+
+	vector<char*> argv;
+	for(string& arg : args) argv.push_back(&arg[0]);
+	int argc = (int)argv.size();
+	char** pArgv = argv.data();
+	ProgramOptions po(argc, pArgv);
+	if(po.help) {
+		EXIT("error: help is only available on the command line\n");
+	}
+}
+
+// builds the instance like loadPCSTP
+static Inst buildInst(const Problem& pr)
+{
+	const int n = pr.nNodes;
+	const int nEdges = (int)pr.tail.size();
+	if(n <= 0) {
+		EXIT("error: problem without nodes\n");
+	}
+	if((int)pr.head.size() != nEdges || (int)pr.cost.size() != nEdges || (int)pr.prize.size() != n) {
+		EXIT("error: sizes of problem arrays do not match\n");
+	}
+	if(pr.root < -1 || pr.root >= n) {
+		EXIT("error: invalid root %d\n", pr.root);
+	}
+
+	Inst inst;
+	inst.offset = 0.0;
+	inst.r = -1;
+	inst.isInt = true;
+	inst.isAsym = pr.directed;
+	inst.resizeNodes(n);
+	inst.resizeEdges(pr.directed ? nEdges : 2*nEdges);
+
+	for(int e = 0; e < nEdges; e++) {
+		if(pr.tail[e] < 0 || pr.tail[e] >= n || pr.head[e] < 0 || pr.head[e] >= n) {
+			EXIT("error: edge %d has an invalid end node\n", e);
+		}
+		if(!(pr.cost[e] >= 0.0)) {
+			EXIT("error: edge %d has a negative cost\n", e);
+		}
+		inst.isInt &= (floor(pr.cost[e]) == pr.cost[e]);
+	}
+	for(int i = 0; i < n; i++) {
+		if(!(pr.prize[i] >= 0.0)) {
+			EXIT("error: node %d has a negative prize\n", i);
+		}
+		inst.isInt &= (floor(pr.prize[i]) == pr.prize[i]);
+	}
+
+	auto weight = [&](double w) { return inst.isInt ? (weight_t)w : (weight_t)round(w * params.precision); };
+
+	int ij = 0;
+	for(int e = 0; e < nEdges; e++) {
+		const int i = pr.tail[e], j = pr.head[e];
+		if(pr.directed) {
+			inst.defineArc(i, j, ij, -1, weight(pr.cost[e])); ij++;
+		} else {
+			inst.defineArc(i, j, ij, ij+1, weight(pr.cost[e])); ij++;
+			inst.defineArc(j, i, ij, ij-1, weight(pr.cost[e])); ij++;
+		}
+	}
+	for(int i = 0; i < n; i++) {
+		inst.p[i] = weight(pr.prize[i]);
+	}
+
+	if(pr.root != -1) {
+		inst.r = pr.root;
+		inst.T[inst.r] = true;
+		inst.f1[inst.r] = true;
+		inst.p[inst.r] = WMAX;
+	}
+
+	inst.buildAdjacency(ij, params.threads);
+	finalizeInst(inst);
+
+	return inst;
+}
+
+static Status status(BBTree& bbtree, const atomic<bool>* cancel)
+{
+	if(bbtree.getGap() <= 0.0)
+		return Status::Optimal;
+	if(cancel != nullptr && *cancel)
+		return Status::Cancelled;
+
+	switch(bbtree.getState()) {
+		case BBTree::BB_TIMELIMIT: return Status::TimeLimit;
+		case BBTree::BB_NODELIMIT:
+		case BBTree::BB_SOLLIMIT:  return Status::NodeLimit;
+		case BBTree::BB_MEMLIMIT:  return Status::MemLimit;
+		default:                   return Status::Optimal;
+	}
+}
+
+// solves the problem, or the instance file content if problem is null
+static Result solveInst(const vector<string>& options, const function<void(double, double)>& incumbentCallback,
+		const atomic<bool>* cancel, const Problem* problem, const char* data, size_t size)
+{
+	Result res;
+	SolveContext ctx;
+
+	try {
+		parseOptions(options);
+		seedRandom(params.seed);
+
+		Inst inst;
+		if(problem != nullptr) {
+			inst = buildInst(*problem);
+			stats.initial = inst.countInstSize();
+			stats.bidirect = bidirectRatio(inst);
+		} else {
+			inst = loadData(data, size);
+		}
+		stats.name = "problem";
+
+		BBTree bbtree(inst);
+		bbtree.setOutput(false);
+		bbtree.setCancelFlag(cancel);
+		if(incumbentCallback) {
+			auto f = incumbentCallback;
+			bbtree.setIncumbentCallback([f, &inst](weight_t obj) {
+				f(format(obj, inst), Timer::total.elapsed().getSeconds());
+			});
+		}
+
+		if(params.initprep) {
+			Timer tPrep(true);
+			bbtree.initPrep();
+			stats.prep = inst.countInstSize();
+			stats.preptime = tPrep.elapsed().getSeconds();
+		}
+
+		if(params.cutoff > 0.0)
+			bbtree.setCutUp(params.cutoff);
+
+		bbtree.initHeur();
+		if(params.timelimit >= 0)
+			bbtree.setTimeLim(max(0.0, params.timelimit-Timer::total.elapsed().getSeconds()));
+		if(params.nodelimit >= 0)
+			bbtree.setNodeLim(params.nodelimit);
+		bbtree.solve();
+
+		stats.bbnodes    = bbtree.getNnodes();
+		stats.isInt      = inst.isInt;
+		stats.isAsym     = inst.isAsym;
+		stats.bbtime     = bbtree.getTime();
+		stats.timeBest   = bbtree.getTimeBest();
+		stats.roottime   = bbtree.getRootTime();
+		stats.heurtime   = bbtree.getHeurTime();
+		stats.heurbbtime = bbtree.getHeurBBTime();
+		stats.ub         = format(bbtree.getUB(), inst);
+		stats.lb         = format(bbtree.getLB(), inst);
+		stats.gap        = gapP(stats.lb, stats.ub);
+		stats.rootub     = format(bbtree.getRootUB(), inst);
+		stats.rootlb     = format(bbtree.getRootLB(), inst);
+		stats.rootgap    = gapP(stats.rootlb, stats.rootub);
+		stats.roots      = bbtree.getNroots();
+		stats.oroots     = bbtree.getNrootsOpen();
+		stats.proots     = bbtree.getNrootsProcessed();
+		stats.time       = Timer::total.elapsed().getSeconds();
+
+		// solution on the original instance, where each edge corresponds to two arcs
+		Sol& S = bbtree.getInc1();
+		stats.valid = S.validate();
+		res.nodes.assign(S.nodes.begin(), S.nodes.end());
+		if(problem != nullptr) {
+			res.edges.assign(problem->tail.size(), 0);
+			for(int ij = 0; ij < (int)S.arcs.size(); ij++) {
+				if(S.arcs[ij]) res.edges[problem->directed ? ij : ij/2] = 1;
+			}
+		}
+		res.solution   = solutionText(bbtree.getInst1(), S);
+
+		res.status     = status(bbtree, cancel);
+		res.objective  = stats.ub;
+		res.lowerBound = stats.lb;
+		res.gap        = stats.gap;
+
+		res.stats.bbNodes   = stats.bbnodes;
+		res.stats.nodesPrep = stats.prep.n;
+		res.stats.arcsPrep  = stats.prep.m;
+		res.stats.rootLB    = stats.rootlb;
+		res.stats.rootUB    = stats.rootub;
+		res.stats.time      = stats.time;
+		res.stats.timeBest  = stats.timeBest;
+		res.stats.prepTime  = stats.preptime;
+		res.stats.heurTime  = stats.heurtime;
+		res.stats.rootTime  = stats.roottime;
+		res.stats.bbTime    = stats.bbtime;
+		res.statsLine       = ProgramStats::statsLine();
+	} catch(const std::exception& e) {
+		res = Result();
+		res.status = Status::Error;
+		res.error = e.what();
+		while(!res.error.empty() && isspace((unsigned char)res.error.back())) res.error.pop_back();
+	}
+
+	return res;
+}
+
+void Solver::setOption(const string& name, const string& value)
+{
+	options.push_back("--" + name);
+	options.push_back(value);
+}
+
+void Solver::setArguments(const vector<string>& args)
+{
+	options.insert(options.end(), args.begin(), args.end());
+}
+
+void Solver::setIncumbentCallback(function<void(double, double)> f)
+{
+	incumbentCallback = f;
+}
+
+void Solver::setCancelFlag(const atomic<bool>* flag)
+{
+	cancel = flag;
+}
+
+Result Solver::solve(const Problem& problem) const
+{
+	return solveInst(options, incumbentCallback, cancel, &problem, nullptr, 0);
+}
+
+Result Solver::solve(const char* data, size_t size) const
+{
+	return solveInst(options, incumbentCallback, cancel, nullptr, data, size);
+}
+
+} // namespace dapcstp
@@ -30,7 +30,7 @@ Sol primI(int r, Inst& inst, vector<weight_t>& tw)
 			if(inst.f0[i]) continue;
 			roots.push_back(i);
 		}
-		r = roots[rand()%roots.size()];
+		r = roots[randomInt()%roots.size()];
 	}
 
 	sol.obj = 0;
@@ -53,7 +53,7 @@ Sol primI(int r, Inst& inst, vector<weight_t>& tw)
 			return sol;
 		}
 		
-		int ri = rootArcs[rand()%rootArcs.size()];
+		int ri = rootArcs[randomInt()%rootArcs.size()];
 		sol.arcs[ri] = true;
 		
 		sol.obj += inst.c[ri];
@@ -10,8 +10,9 @@
 #include "util.h"
 
 #include <stack>
+#include <string.h>
 
-Inst::Inst()
+Inst::Inst() : offset(0), n(0), m(0), t(0), r(-1)
 {
 
 }
@@ -56,6 +57,7 @@ Inst::Inst(const Inst& src)
 	isMWCS = src.isMWCS;
 	inst1 = src.inst1;
 	bigM = src.bigM;
+	arcMoves = src.arcMoves;
 
 	transformation = src.transformation;
 }
@@ -68,11 +70,28 @@ void Inst::newArc(int i, int j, int ij, int ji, weight_t w)
 	din[j].push_back(ij);
 	tail[ij] = i;
 	head[ij] = j;
+	arcMoves++;
 	opposite[ij] = ji;
 	
 	c[ij] = (weight_t)w;
 }
 
+void Inst::defineArc(int i, int j, int ij, int ji, weight_t w)
+{
+	tail[ij] = i;
+	head[ij] = j;
+	arcMoves++;
+	opposite[ij] = ji;
+
+	c[ij] = w;
+}
+
+void Inst::buildAdjacency(int nArcs, int nThreads)
+{
+	din.build(n, head, nArcs, pin, nThreads);
+	dout.build(n, tail, nArcs, pout, nThreads);
+}
+
 void Inst::delArc(int ij)
 {
 	int i = tail[ij];
@@ -151,6 +170,7 @@ void Inst::moveHead(int ij, int k)
 	// place ij in new adj list
 	head[ij] = k;
 	pin[ij] = din[k].size();
+	arcMoves++;
 	din[k].push_back(ij);
 }
 
@@ -179,6 +199,7 @@ void Inst::moveTail(int ij, int k)
 	// place ij in new adj list
 	tail[ij] = k;
 	pout[ij] = dout[k].size();
+	arcMoves++;
 	dout[k].push_back(ij);
 }
 
@@ -214,8 +235,6 @@ void Inst::merge(int ij, int i, int j)
 
 	assert(din[j].size() == 0);
 	assert(dout[j].size() == 0);
-	din[j].shrink_to_fit();
-	dout[j].shrink_to_fit();
 
 	// seek cheapest incoming/outgoing arcs to neighbors and keep them
 	vector<int> ndistin(n, -1);
@@ -823,3 +842,127 @@ int Inst::countReachableFixed(int r)
 	}
 	return fixed;
 }
+
+// number of elements compared at once, blocks equal to the base are skipped as a whole
+static const int diffBlock = 64;
+
+template<typename T>
+static void diffEntries(const vector<T>& base, const vector<T>& v, vector<pair<int,T>>& entries)
+{
+	const int k = (int)v.size();
+	for(int b = 0; b < k; b += diffBlock) {
+		const int e = min(b+diffBlock, k);
+		if(memcmp(v.data()+b, base.data()+b, (e-b)*sizeof(T)) == 0) continue;
+		for(int i = b; i < e; i++) {
+			if(v[i] != base[i])
+				entries.emplace_back(i, v[i]);
+		}
+	}
+	entries.shrink_to_fit();
+}
+
+static void addList(const int* first, int k, int i, InstDiff::ListEntries& entries)
+{
+	if(entries.beg.empty())
+		entries.beg.push_back(0);
+	entries.idx.push_back(i);
+	entries.data.insert(entries.data.end(), first, first+k);
+	entries.beg.push_back((int)entries.data.size());
+}
+
+static void shrinkLists(InstDiff::ListEntries& entries)
+{
+	entries.idx.shrink_to_fit();
+	entries.beg.shrink_to_fit();
+	entries.data.shrink_to_fit();
+}
+
+static void diffEntries(const vector<vector<int>>& base, const vector<vector<int>>& v, InstDiff::ListEntries& entries)
+{
+	for(int i = 0; i < (int)v.size(); i++) {
+		if(v[i] != base[i])
+			addList(v[i].data(), (int)v[i].size(), i, entries);
+	}
+	shrinkLists(entries);
+}
+
+static void diffEntries(const Adjacency& base, const Adjacency& adj, InstDiff::ListEntries& entries)
+{
+	for(int i = 0; i < adj.size(); i++) {
+		if(adj[i].size() != base[i].size() || !equal(adj[i].begin(), adj[i].end(), base[i].begin()))
+			addList(adj[i].begin(), adj[i].size(), i, entries);
+	}
+	shrinkLists(entries);
+}
+
+static void applyEntries(const InstDiff::ListEntries& entries, Adjacency& adj)
+{
+	for(int k = 0; k < (int)entries.idx.size(); k++) {
+		adj.assign(entries.idx[k], entries.data.data() + entries.beg[k], entries.beg[k+1] - entries.beg[k]);
+	}
+}
+
+static void applyEntries(const InstDiff::ListEntries& entries, vector<vector<int>>& v)
+{
+	for(int k = 0; k < (int)entries.idx.size(); k++) {
+		v[entries.idx[k]].assign(entries.data.begin() + entries.beg[k], entries.data.begin() + entries.beg[k+1]);
+	}
+}
+
+template<typename T>
+static void applyEntries(const vector<pair<int,T>>& entries, vector<T>& v)
+{
+	for(auto& e : entries) {
+		v[e.first] = e.second;
+	}
+}
+
+InstDiff::InstDiff(const Inst& base, const Inst& inst)
+{
+	diffEntries(base.din, inst.din, din);
+	diffEntries(base.dout, inst.dout, dout);
+	diffEntries(base.bmna, inst.bmna, bmna);
+	diffEntries(base.bmaa, inst.bmaa, bmaa);
+	diffEntries(base.tail, inst.tail, tail);
+	diffEntries(base.head, inst.head, head);
+	diffEntries(base.opposite, inst.opposite, opposite);
+	diffEntries(base.pin, inst.pin, pin);
+	diffEntries(base.pout, inst.pout, pout);
+	diffEntries(base.f0, inst.f0, f0);
+	diffEntries(base.f1, inst.f1, f1);
+	diffEntries(base.fe0, inst.fe0, fe0);
+	diffEntries(base.T, inst.T, T);
+	diffEntries(base.c, inst.c, c);
+	diffEntries(base.p, inst.p, p);
+
+	offset = inst.offset;
+	bigM = inst.bigM;
+	t = inst.t;
+	r = inst.r;
+	arcMoves = inst.arcMoves;
+}
+
+void InstDiff::apply(Inst& inst) const
+{
+	applyEntries(din, inst.din);
+	applyEntries(dout, inst.dout);
+	applyEntries(bmna, inst.bmna);
+	applyEntries(bmaa, inst.bmaa);
+	applyEntries(tail, inst.tail);
+	applyEntries(head, inst.head);
+	applyEntries(opposite, inst.opposite);
+	applyEntries(pin, inst.pin);
+	applyEntries(pout, inst.pout);
+	applyEntries(f0, inst.f0);
+	applyEntries(f1, inst.f1);
+	applyEntries(fe0, inst.fe0);
+	applyEntries(T, inst.T);
+	applyEntries(c, inst.c);
+	applyEntries(p, inst.p);
+
+	inst.offset = offset;
+	inst.bigM = bigM;
+	inst.t = t;
+	inst.r = r;
+	inst.arcMoves = arcMoves;
+}
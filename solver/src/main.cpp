@@ -8,6 +8,10 @@
 
 #include <stdio.h>
 #include <vector>
+#include <fstream>
+#include <sstream>
+#include <mutex>
+#include <atomic>
 #include <boost/filesystem.hpp>
 
 #include "stats.h"
@@ -17,26 +21,169 @@
 #include "ds.h"
 #include "util.h"
 #include "bbtree.h"
+#include "cache.h"
 #include "prep.h"
+#include "parallel.h"
+#include "server.h"
 
 Inst load();
 void solve(Inst& inst);
+void solveBatch(int argc, char *argv[]);
+static void solvePortfolio(Inst& inst);
+static void runSolve(BBTree& bbtree, Inst& inst);
+static void report(BBTree& bbtree, Inst& inst);
 
-double bestKnown = -1;
+thread_local double bestKnown = -1;
+// terminal output of the current solve, disabled for solves in batch mode
+thread_local bool bOutput = true;
+// command line of the current solve, extended by the configurations of --portfolio
+thread_local vector<char*> solveArgv;
+
+// configurations of the built-in portfolio
+static const char* defaultPortfolio[] = {
+	"-",
+	"--bb.nodeselect 1",
+	"--bb.branchtype 1",
+	"--bb.daiterations 1 --heur.roots 1",
+};
+
+// splits a line of a batch or portfolio file into its arguments
+static vector<string> splitArgs(const string& line)
+{
+	istringstream tokens(line);
+	vector<string> args;
+	string arg;
+	while(tokens >> arg) args.push_back(arg);
+	return args;
+}
+
+// prints the message of an error, messages of EXIT end with a newline already
+static void printError(const std::exception& e)
+{
+	const string msg = e.what();
+	fputs(msg.c_str(), stderr);
+	if(msg.empty() || msg.back() != '\n') fputc('\n', stderr);
+}
 
 int main(int argc, char *argv[])
 {
-	enlargeStack();
-	ProgramOptions po(argc, argv);
-	ProcStatus::setMemLimit(params.memlimit);
-	srand(params.seed);
+	// the thread local total timer is only constructed on first use, load and prep count as well
+	Timer::total.start();
+
+	try {
+		ProgramOptions po(argc, argv);
+		if(po.help) {
+			fputs(po.helpText.c_str(), stdout);
+			return 0;
+		}
+		if(params.file.empty() && params.batchfile.empty() && params.servepath.empty()) {
+			printf("No input file given!\n");
+			return 0;
+		}
+		solveArgv.assign(argv, argv+argc);
+		ProcStatus::setMemLimit(params.memlimit);
 
-	Inst inst = load();
-	solve(inst);
+		if(!params.batchfile.empty()) {
+			solveBatch(argc, argv);
+			return 0;
+		}
+
+		if(!params.servepath.empty()) {
+			serve(params.servepath.c_str(), argc, argv);
+			return 0;
+		}
+
+		seedRandom(params.seed);
+
+		Inst inst = load();
+		solve(inst);
+	} catch(const std::exception& e) {
+		printError(e);
+		return 1;
+	}
 
 	return 0;
 }
 
+// solves the instances listed in the batch file on --jobs threads. Each line consists of an
+// instance file followed by options, which are parsed together with the command line options.
+// The statistics rows are written to the --stats file in the order of the batch file.
+void solveBatch(int argc, char *argv[])
+{
+	ifstream in(params.batchfile);
+	if(!in) {
+		EXIT("error: file not found: %s\n", params.batchfile.c_str());
+	}
+
+	vector<vector<string>> jobs;
+	string line;
+	while(getline(in, line)) {
+		vector<string> args = splitArgs(line);
+		if(args.empty() || args[0][0] == '#') continue;
+		jobs.push_back(args);
+	}
+
+	FILE* fp = NULL;
+	if(!params.statsfile.empty() && (fp=fopen(params.statsfile.c_str(), "w")) == NULL) {
+		EXIT("error writing stats: %s\n", params.statsfile.c_str());
+	}
+
+	// rows are written as soon as all rows before them are complete
+	vector<string> rows(jobs.size());
+	vector<bool> done(jobs.size(), false);
+	size_t nWritten = 0;
+	mutex mtxRows;
+	atomic<size_t> nextJob{0};
+
+	runThreads(max(1, params.jobs), [&](int) {
+		bOutput = false;
+		for(size_t k; (k = nextJob++) < jobs.size(); ) {
+			vector<char*> jobArgv(argv, argv+argc);
+			for(string& arg : jobs[k]) jobArgv.push_back(&arg[0]);
+			int jobArgc = (int)jobArgv.size();
+			char** pJobArgv = jobArgv.data();
+
+			// a failed instance has no row in the statistics file
+			string row;
+			try {
+				ProgramOptions po(jobArgc, pJobArgv);
+				if(po.help) {
+					EXIT("error: help is only available on the command line\n");
+				}
+				solveArgv = jobArgv;
+				params.batchfile.clear();
+				params.statsfile.clear();
+				stats = ProgramStats::Stats();
+				Timer::total.start();
+				seedRandom(params.seed);
+
+				ProcStatus::SolveGuard guard;
+				Inst inst = load();
+				solve(inst);
+				row = ProgramStats::statsLine();
+			} catch(const std::exception& e) {
+				fprintf(stderr, "%s: ", jobs[k][0].c_str());
+				printError(e);
+			}
+
+			lock_guard<mutex> lock(mtxRows);
+			rows[k] = row;
+			done[k] = true;
+			for(; nWritten < jobs.size() && done[nWritten]; nWritten++) {
+				if(fp != NULL) {
+					fputs(rows[nWritten].c_str(), fp);
+					fflush(fp);
+				}
+				string().swap(rows[nWritten]);
+			}
+		}
+	});
+
+	if(fp != NULL) {
+		fclose(fp);
+	}
+}
+
 Inst load()
 {
 	// load instance file
@@ -45,6 +192,7 @@ Inst load()
 	}
 
 	Timer tLoad(true);
+	bestKnown = -1;
 	Inst inst = load(params.file.c_str());
 	if(params.bigM) {
 		if(inst.r == -1) {
@@ -59,6 +207,9 @@ Inst load()
 	if(!params.boundsfile.empty()) {
 		bestKnown = getBestKnownBound(params.file.c_str(), params.boundsfile.c_str());
 	}
+
+	if(!bOutput)
+		return inst;
 	
 	printf("[ %sload%s   ] [ %s%5.1lf s%s ] ", GREEN, NORMAL, GRAY, tLoad.elapsed().getSeconds(), NORMAL);
 	printf("n %5d m %5d t %5d ", inst.n, inst.m, inst.t);
@@ -79,28 +230,184 @@ Inst load()
 
 void solve(Inst& inst)
 {
+	if(params.bigM && (!params.statefile.empty() || !params.stateoutfile.empty() || !params.deltafile.empty() || !params.checkpointfile.empty() || !params.resumefile.empty())) {
+		EXIT("error: solve states, checkpoints and delta files are not supported with --bigM\n");
+	}
+	if(!params.resumefile.empty() && (!params.statefile.empty() || !params.deltafile.empty())) {
+		EXIT("error: --resume cannot be combined with --state and --delta\n");
+	}
+	if(!params.deltafile.empty()) {
+		const int nChanges = applyDelta(inst, params.deltafile.c_str());
+		if(bOutput)
+			printf("[ %sdelta%s  ] %d changes of prizes and costs\n\n", GREEN, NORMAL, nChanges);
+	}
+
+	if(!params.portfolio.empty()) {
+		solvePortfolio(inst);
+		return;
+	}
+
 	BBTree bbtree(inst);
+	bbtree.setOutput(bOutput);
+	runSolve(bbtree, inst);
+	report(bbtree, inst);
+}
+
+// runs the configurations of the portfolio concurrently, each on its own copy of the instance and with
+// its own preprocessing. Incumbents and lower bounds are shared as objective values (see
+// PortfolioBounds), the solve is reported with the member holding the best incumbent.
+static void solvePortfolio(Inst& inst)
+{
+	if(!params.statefile.empty() || !params.stateoutfile.empty() || !params.presolvedoutfile.empty() || !params.checkpointfile.empty() || !params.resumefile.empty()) {
+		EXIT("error: solve states, checkpoints and presolve snapshots for output are not supported with --portfolio\n");
+	}
+
+	vector<vector<string>> configs;
+	if(params.portfolio.compare("default") == 0) {
+		for(const char* line : defaultPortfolio)
+			configs.push_back(splitArgs(line));
+	} else {
+		ifstream in(params.portfolio);
+		if(!in) {
+			EXIT("error: file not found: %s\n", params.portfolio.c_str());
+		}
+		string line;
+		while(getline(in, line)) {
+			vector<string> args = splitArgs(line);
+			if(args.empty() || args[0][0] == '#') continue;
+			configs.push_back(args);
+		}
+	}
+	if(configs.empty()) {
+		EXIT("error: empty portfolio: %s\n", params.portfolio.c_str());
+	}
+
+	// options of the members, given after the command line
+	const ProgramOptions::Parameters base = params;
+	vector<ProgramOptions::Parameters> configParams;
+	for(auto& args : configs) {
+		vector<char*> argv1(solveArgv);
+		for(string& arg : args)
+			if(arg.compare("-") != 0) argv1.push_back(&arg[0]);
+		int argc1 = (int)argv1.size();
+		char** pArgv1 = argv1.data();
+		ProgramOptions po(argc1, pArgv1);
+		if(po.help) {
+			EXIT("error: help is only available on the command line\n");
+		}
+		configParams.push_back(params);
+	}
+	params = base;
+
+	const int n = (int)configs.size();
+	PortfolioBounds bounds;
+	vector<Inst> insts(n, inst);
+	vector<unique_ptr<BBTree>> trees(n);
+	vector<ProgramStats::Stats> memberStats(n);
+	const double known = bestKnown;
+
+	Timer tPortfolio(true);
+	runThreads(n, [&](int k) {
+		params = configParams[k];
+		bestKnown = known;
+		bOutput = false;
+		try {
+			trees[k].reset(new BBTree(insts[k]));
+			trees[k]->setOutput(false);
+			trees[k]->setPortfolio(&bounds, k);
+			runSolve(*trees[k], insts[k]);
+		} catch(...) {
+			bounds.stop = true;
+			throw;
+		}
+		memberStats[k] = stats;
+	});
+
+	// the winner may have proven optimality with the incumbent of another member
+	const int winner = bounds.winner;
+	int best = max(winner, 0);
+	for(int k = 0; k < n; k++) {
+		if(trees[k]->getInc1().obj < trees[best]->getInc1().obj)
+			best = k;
+	}
+	trees[best]->importPortfolioBounds();
+
+	// statistics of the reported member, the instance data was collected when loading
+	const ProgramStats::Stats loaded = stats;
+	stats = memberStats[best];
+	stats.name = loaded.name;
+	stats.initial = loaded.initial;
+	stats.bidirect = loaded.bidirect;
+	stats.portfolio = winner;
 
+	if(bOutput) {
+		printf("[ %sportfolio%s ] [ %s%5.1lf s%s ] %d configurations, ", GREEN, NORMAL, GRAY, tPortfolio.elapsed().getSeconds(), NORMAL, n);
+		if(winner >= 0) {
+			printf("optimality proven first by %d (", winner);
+			for(auto& arg : configs[winner]) printf(" %s", arg.c_str());
+			printf(" )");
+		} else {
+			printf("optimality not proven");
+		}
+		printf(", incumbent of %d\n\n", best);
+	}
+
+	// the row of the statistics file lists the options of the reported member
+	params = configParams[best];
+	report(*trees[best], insts[best]);
+	params = base;
+}
+
+// preprocesses and solves the instance of bbtree
+static void runSolve(BBTree& bbtree, Inst& inst)
+{
 	if(!params.solfile.empty()) {
 		Sol start = loadSol(params.solfile.c_str(), inst);
 		bbtree.setIncumbent(start);
 	}
 
-	if(params.initprep) {
+	// the state is referenced by the tree until it is solved
+	ReoptState state;
+	if(!params.statefile.empty()) {
+		if(!loadReoptState(params.statefile.c_str(), state)) {
+			EXIT("error: invalid solve state file: %s\n", params.statefile.c_str());
+		}
+		bbtree.setReoptState(state);
+	}
+	if(!params.resumefile.empty()) {
+		if(!loadReoptState(params.resumefile.c_str(), state)) {
+			EXIT("error: invalid checkpoint file: %s\n", params.resumefile.c_str());
+		}
+		bbtree.setResume(state);
+	}
+	if(!params.stateoutfile.empty())
+		bbtree.recordState();
+	if(!params.checkpointfile.empty())
+		bbtree.setCheckpoint(params.checkpointfile, params.checkpointfreq);
+
+	if(params.initprep || !params.presolvedfile.empty()) {
 		Timer tPrep(true);
-		bbtree.initPrep();
+		if(!params.presolvedfile.empty())
+			bbtree.loadPrep(params.presolvedfile.c_str());
+		else
+			bbtree.initPrep();
 		stats.prep = inst.countInstSize();
 		stats.preptime = tPrep.elapsed().getSeconds();
-		printf("[ %sprep%s   ] [ %s%5.1lf s%s ] ( %4.1lf %% )", GREEN, NORMAL, GRAY, stats.preptime, NORMAL, stats.prep.m*100.0/inst.m);
-		// big-M is only relevant for unrooted instances
-		if(params.semiBigM && inst.r == -1) {
-			printf(" lbM ");
-			if(inst.isInt)
-				printf("%13.0lf", format(bbtree.getLBM(), inst));
-			else
-				printf("%13.6lf", format(bbtree.getLBM(), inst));
+		if(bOutput) {
+			printf("[ %sprep%s   ] [ %s%5.1lf s%s ] ( %4.1lf %% )", GREEN, NORMAL, GRAY, stats.preptime, NORMAL, stats.prep.m*100.0/inst.m);
+			// big-M is only relevant for unrooted instances
+			if(params.semiBigM && inst.r == -1) {
+				printf(" lbM ");
+				if(inst.isInt)
+					printf("%13.0lf", format(bbtree.getLBM(), inst));
+				else
+					printf("%13.6lf", format(bbtree.getLBM(), inst));
+			}
+			printf("\n\n");
 		}
-		printf("\n\n");
+
+		if(!params.presolvedoutfile.empty())
+			bbtree.savePrep(params.presolvedoutfile.c_str());
 	}
 
 	if(params.cutoff > 0.0)
@@ -131,6 +438,13 @@ void solve(Inst& inst)
 		bbtree.solve();
 	}
 
+	if(!params.stateoutfile.empty())
+		bbtree.saveReoptState(params.stateoutfile.c_str());
+}
+
+// prints the result of a solve and writes the statistics and solution files
+static void report(BBTree& bbtree, Inst& inst)
+{
 	stats.bbnodes = bbtree.getNnodes();
 	stats.isInt   = inst.isInt;
 	stats.isAsym  = inst.isAsym;
@@ -170,27 +484,37 @@ void solve(Inst& inst)
 	stats.valid = S.validate();
 	
 	//printf("v %6d e %6d t %6d tr %6d bb %6d ", stats.initial.n, stats.initial.m, stats.initial.t, stats.initial.tr, bbtree.getIter());
-	printf("bbnodes  %15d\n", bbtree.getNnodes());
-	printf("ub       ");
-	printBoundPadded(inst, ub);
-	printf("\n");
-	printf("lb       ");
-	printBoundPadded(inst, lb);
-	printf("\n");
-	printf("rootub   ");
-	printBoundPadded(inst, bbtree.getRootUB());
-	printf("\n");
-	printf("rootlb   ");
-	printBoundPadded(inst, bbtree.getRootLB());
-	printf("\n");
-	printf("gap      %15.3lf\n", bbtree.getGap());
-	printf("gapR     %15.3lf\n", bbtree.getRootGap());
-	printf("timeBest %15.1lf\n", stats.timeBest);
-	printf("time     %15.1lf\n", stats.time);
-	printf("matches  %15d\n", match);
-	printf("valid    %15d\n", (int)stats.valid);
-
-	printf("lc %5d d1 %5d d2 %5d ma %5d ms %5d ss %5d nr %5d bb %5d\n", stats.lc, stats.d1, stats.d2, stats.ma, stats.ms, stats.ss, stats.nr, stats.boundbased);
+	if(bOutput) {
+		printf("bbnodes  %15d\n", bbtree.getNnodes());
+		printf("ub       ");
+		printBoundPadded(inst, ub);
+		printf("\n");
+		printf("lb       ");
+		printBoundPadded(inst, lb);
+		printf("\n");
+		printf("rootub   ");
+		printBoundPadded(inst, bbtree.getRootUB());
+		printf("\n");
+		printf("rootlb   ");
+		printBoundPadded(inst, bbtree.getRootLB());
+		printf("\n");
+		printf("gap      %15.3lf\n", bbtree.getGap());
+		printf("gapR     %15.3lf\n", bbtree.getRootGap());
+		printf("timeBest %15.1lf\n", stats.timeBest);
+		printf("time     %15.1lf\n", stats.time);
+		printf("matches  %15d\n", match);
+		printf("valid    %15d\n", (int)stats.valid);
+		if(!params.portfolio.empty())
+			printf("winner   %15d\n", stats.portfolio);
+
+		printf("lc %5d d1 %5d d2 %5d ma %5d ms %5d ss %5d nr %5d bb %5d\n", stats.lc, stats.d1, stats.d2, stats.ma, stats.ms, stats.ss, stats.nr, stats.boundbased);
+		if(params.heurasync > 0)
+			printf("heur async: queued %d dropped %d max queue %d improved %d\n", stats.heurjobs, stats.heurdrops, stats.heurqueue, stats.heurimproved);
+		if(stats.spilled > 0)
+			printf("spill: nodes %d read back %d file %.1lf MB\n", stats.spilled, stats.unspilled, stats.spillmb);
+		if(stats.probes > 0)
+			printf("reliability branching: probes %d\n", stats.probes);
+	}
 
 	// write output files (solution + stats)
 	if(!params.statsfile.empty()) {
@@ -205,6 +529,11 @@ void solve(Inst& inst)
 		delete inst.transformation;
 	}
 
-	if(params.printstatsline)
-		printf("STAT;%s;%d;%d;%d;%.6lf;%.6lf;%.6lf;%.3lf;%d;%d;%d\n", stats.name.c_str(), inst.n, inst.m, stats.bbnodes, stats.gap, stats.lb, stats.ub, stats.time, stats.valid, match, stats.memout);
+	// with --portfolio, the configuration that proved optimality first is appended (-1: none)
+	if(params.printstatsline) {
+		printf("STAT;%s;%d;%d;%d;%.6lf;%.6lf;%.6lf;%.3lf;%d;%d;%d", stats.name.c_str(), inst.n, inst.m, stats.bbnodes, stats.gap, stats.lb, stats.ub, stats.time, stats.valid, match, stats.memout);
+		if(!params.portfolio.empty())
+			printf(";%d", stats.portfolio);
+		printf("\n");
+	}
 }
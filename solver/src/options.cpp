@@ -9,11 +9,12 @@
 #include "options.h"
 #include <boost/program_options.hpp>
 #include <iostream>
+#include <sstream>
 
 using namespace std;
 namespace po = boost::program_options;
 
-ProgramOptions::Parameters params;
+thread_local ProgramOptions::Parameters params;
 
 ProgramOptions::ProgramOptions(int &argc, char ** &argv)
 {
@@ -22,15 +23,29 @@ ProgramOptions::ProgramOptions(int &argc, char ** &argv)
 			("help,h", "produce help message")
 			("file,f", po::value<string>(&params.file)->default_value(""), "instance file to process")
 			("solout,o", po::value<string>(&params.soloutfile)->default_value(""), "solution file for output")
+			("cache", po::value<bool>(&params.cache)->default_value(false)->implicit_value(true), "write the loaded instance to a binary cache file (<file>.stpb), which later runs load instead of the instance file")
 			("stats", po::value<string>(&params.statsfile)->default_value(""), "statistics file for output")
 			("sol", po::value<string>(&params.solfile)->default_value(""), "solution file for starting solution")
 			("bounds", po::value<string>(&params.boundsfile)->default_value(""), "bounds file for input")
+			("presolved", po::value<string>(&params.presolvedfile)->default_value(""), "presolve snapshot file (written with --presolvedout for the same instance) replacing the initial preprocessing")
+			("presolvedout", po::value<string>(&params.presolvedoutfile)->default_value(""), "presolve snapshot file for output, contains the preprocessed instance and its backmapping")
+			("stateout", po::value<string>(&params.stateoutfile)->default_value(""), "solve state file for output, used by --state to solve the instance again after changes of prizes and costs (nodes below the roots then only use bound-based reductions)")
+			("state", po::value<string>(&params.statefile)->default_value(""), "solve state file (written with --stateout for the same graph), its incumbent and bounds are reused as far as the changed weights allow")
+			("delta", po::value<string>(&params.deltafile)->default_value(""), "changes of the loaded instance, one per line: E <i> <j> <cost> or TP <i> <prize> (pcstp|stp)")
+			("checkpoint", po::value<string>(&params.checkpointfile)->default_value(""), "checkpoint file, replaced periodically during the B&B and when it ends by the incumbent, the open nodes and the branching priorities")
+			("checkpoint.freq", po::value<double>(&params.checkpointfreq)->default_value(300), "seconds between checkpoints")
+			("resume", po::value<string>(&params.resumefile)->default_value(""), "checkpoint file (written with --checkpoint for the same instance and options) whose search is continued")
 			("precision", po::value<long>(&params.precision)->default_value(-1), "decimal precision read from file (-1: choose automatically 12 for mwcs and 6 for the rest)")
 			("printstatsline", po::value<bool>(&params.printstatsline)->default_value(true)->implicit_value(true), "print line containing stats values for quick parsing")
 			("type", po::value<string>(&params.type)->default_value("pcstp"), "instance problem type (pcstp|stp|mwcs|nwstp)")
 			("seed", po::value<int>(&params.seed)->default_value(0), "random seed")
+			("threads", po::value<int>(&params.threads)->default_value(1), "number of threads")
+			("batch", po::value<string>(&params.batchfile)->default_value(""), "file listing instances to solve in one process, one per line optionally followed by options overriding the command line; --stats collects one row per instance")
+			("portfolio", po::value<string>(&params.portfolio)->default_value(""), "file listing configurations solving the instance concurrently, one per line given by options overriding the command line (-: unchanged); they share their bounds and the first one proving optimality stops the others, its index (from 0) is reported as winner and appended to the STAT line (default: built-in portfolio)")
+			("jobs", po::value<int>(&params.jobs)->default_value(1), "number of instances solved concurrently in batch and server mode")
+			("serve", po::value<string>(&params.servepath)->default_value(""), "run as a daemon solving instances sent over the unix domain socket at this path (protocol: see server.cpp), the command line options are the defaults of every request")
 			("timelimit,t", po::value<double>(&params.timelimit)->default_value(-1), "timelimit")
-			("memlimit,m", po::value<int>(&params.memlimit)->default_value(15 * 1024), "memory limit")
+			("memlimit,m", po::value<int>(&params.memlimit)->default_value(15 * 1024), "memory limit of the process in MB, with --jobs each concurrent solve of batch and server mode gets an equal part of it and is charged with an equal part of the memory of the process")
 			;
 
 			// B&B parameters
@@ -40,11 +55,21 @@ ProgramOptions::ProgramOptions(int &argc, char ** &argv)
 			("bb.cutupopt", po::value<bool>(&params.cutoffopt)->default_value(false)->implicit_value(true), "choose cutup from bounds file (specify with --bounds pathtofile)")
 			("bb.absgap", po::value<double>(&params.absgap)->default_value(0), "absolute optimality gap")
 			("bb.infofreq", po::value<int>(&params.bbinfofreq)->default_value(100), "number of nodes after which the B&B status information is updated")
-			("bb.branchtype", po::value<int>(&params.branchtype)->default_value(0), "branching type")
-			("bb.nodeselect", po::value<int>(&params.nodeselect)->default_value(0), "node selection strategy")
+			("bb.branchtype", po::value<int>(&params.branchtype)->default_value(0), "branching type (4: reliability branching, probing candidates by a truncated dual ascent)")
+			("bb.relcands", po::value<int>(&params.relcands)->default_value(8), "--bb.branchtype 4 probes at most this number of candidates per node")
+			("bb.reliability", po::value<int>(&params.reliability)->default_value(4), "--bb.branchtype 4 stops probing a candidate after this number of probes and uses its pseudo-costs")
+			("bb.probeiter", po::value<int>(&params.probeiter)->default_value(0), "limit of the number of augmentations of the dual ascent of a probe of --bb.branchtype 4 (0: no limit)")
+			("bb.nodeselect", po::value<int>(&params.nodeselect)->default_value(0), "node selection strategy (0: worst-bound, 1: dfs, 2: best-bound, 3: hybrid, plunging into children close to the best bound)")
+			("bb.plungequot", po::value<double>(&params.plungequot)->default_value(0.25), "--bb.nodeselect 3 continues with a child while its bound exceeds the best bound by at most this fraction of the gap")
+			("bb.plungeopen", po::value<int>(&params.plungeopen)->default_value(10000), "--bb.nodeselect 3 takes the deepest node instead of the best-bound node above this number of open nodes (0: never)")
 			("bb.daiterations", po::value<int>(&params.daiterations)->default_value(10), "number of dual ascent iterations per B&B node (minimum: 1)")
 			("bb.perturbedheur", po::value<bool>(&params.perturbedheur)->default_value(true)->implicit_value(true), "calls the primal heuristic on the support graph with perturbed cost (deactivated automatically if --heur.eps=0)")
 			("bb.nodelimit,m", po::value<int>(&params.nodelimit)->default_value(-1), "node limit")
+			("bb.trail", po::value<bool>(&params.bbtrail)->default_value(true)->implicit_value(true), "store open nodes as difference to the instance of their subtree root instead of a full copy, which takes far less memory but some more time for computing and applying the differences")
+			("bb.spill", po::value<double>(&params.spill)->default_value(0.75), "fraction of the memory limit above which the open nodes selected last are moved to a temporary file while the resident memory exceeds it, requires --bb.trail (0: never); the resident memory is then also compared with --memlimit, the virtual size otherwise")
+			("bb.spilldir", po::value<string>(&params.spilldir)->default_value(""), "directory of the temporary file of --bb.spill (default: system temporary directory)")
+			("bb.warmstart", po::value<bool>(&params.bbwarmstart)->default_value(false)->implicit_value(true), "start dual ascent in child nodes from the dual solution of their parent")
+			("bb.rootlookahead", po::value<int>(&params.rootlookahead)->default_value(0), "number of roots evaluated speculatively ahead of the current one on symmetric instances with --threads > 1 (0: twice the number of threads)")
 			;
 
 			// dual ascent parameters
@@ -53,6 +78,8 @@ ProgramOptions::ProgramOptions(int &argc, char ** &argv)
 			("da.eager", po::value<double>(&params.daeager)->default_value(1.25), "threshold below which an element of the DA priority queue is processed, even if its score is higher than the next element")
 			("da.sat", po::value<double>(&params.dasat)->default_value(-1), "threshold below which an arc is viewed as saturated within the dual ascent algorithm")
 			("da.guide", po::value<bool>(&params.daguide)->default_value(true)->implicit_value(true), "use guiding solutions")
+			("da.bucketqueue", po::value<bool>(&params.dabucket)->default_value(false)->implicit_value(true), "use a bucket queue instead of a binary heap for the active components")
+			("da.simd", po::value<bool>(&params.dasimd)->default_value(true)->implicit_value(true), "use AVX2/AVX-512 kernels for augmentations if supported by the CPU")
 			("da.lastcomp", po::value<bool>(&params.lastcomp), "lastcomp")
 			;
 
@@ -76,6 +103,8 @@ ProgramOptions::ProgramOptions(int &argc, char ** &argv)
 			("heur.roots", po::value<int>(&params.heurroots)->default_value(10), "number of roots for initial heuristics")
 			("heur.bb", po::value<bool>(&params.heurbb)->default_value(true)->implicit_value(true), "heuristic that applies B&B on the support graphs created during the initialization heuristic and union of starting solutions")
 			("heur.bbtime", po::value<double>(&params.heurbbtime)->default_value(10.0), "time limit for b&b heuristic")
+			("heur.async", po::value<int>(&params.heurasync)->default_value(0), "number of threads running the primal heuristic of the B&B nodes, which then only queue their support graphs (0: run it within the node)")
+			("heur.queue", po::value<int>(&params.heurqueue)->default_value(0), "number of support graphs queued for --heur.async, nodes are not queued while it is full (0: twice the number of threads)")
 			("heur.supportG", po::value<bool>(&params.heursupportG)->default_value(true)->implicit_value(true), "apply shortest path heuristic on support graph computed by dual ascent")
 			;
 
@@ -123,19 +152,17 @@ ProgramOptions::ProgramOptions(int &argc, char ** &argv)
 		params.precision *= 10;
 	}
 
+	// the caller reports the help, parsing options never ends the process
 	if (vm.count("help")) {
-	    cout << general_options << endl;
-	    cout << bb_options << endl;
-	    cout << da_options << endl;
-	    cout << comp_options << endl;
-	    cout << heur_options << endl;
-	    cout << red_options << endl;
-	    exit(0);
-	}
-	else if (!vm.count("file"))
-	{
-		cout << "No input file given!" << endl;
-		exit(0);
+		ostringstream out;
+		out << general_options << endl;
+		out << bb_options << endl;
+		out << da_options << endl;
+		out << comp_options << endl;
+		out << heur_options << endl;
+		out << red_options << endl;
+		help = true;
+		helpText = out.str();
 	}
 }
 
@@ -8,8 +8,11 @@
 
 #include "procstatus.h"
 
+#include <unistd.h>
+
 u_int ProcStatus::memlimit = numeric_limits<u_int>::max();
 u_int ProcStatus::maxusedmem = 0;
+atomic<int> ProcStatus::solves{0};
 
 ProcStatus::ProcStatus()
 {
@@ -34,6 +37,24 @@ u_int ProcStatus::mem()
 	return ceil( mb );
 }
 
+u_int ProcStatus::resident()
+{
+	unsigned long pages = 0;
+	{
+		unsigned long ignore;
+		ifstream ifs( "/proc/self/statm", std::ios_base::in );
+		ifs >> ignore >> pages;
+	}
+	double mb = (double) pages * sysconf(_SC_PAGESIZE) / (1024 * 1024);
+	return ceil( mb );
+}
+
+u_int ProcStatus::share(u_int mb)
+{
+	const int n = solves;
+	return n > 1 ? mb / n : mb;
+}
+
 bool ProcStatus::memOK()
 {
 	u_int mb = mem();
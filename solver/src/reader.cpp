@@ -0,0 +1,105 @@
+/**
+ * \file   reader.cpp
+ * \brief  line-based reader for instance files
+ *
+ * \author Martin Luipersbeck
+ * \date   2026-10-17
+ */
+
+#include "reader.h"
+#include "def.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+MappedFile::MappedFile(const char* fn)
+{
+	const int fd = ::open(fn, O_RDONLY);
+	if(fd < 0) return;
+	open = true;
+
+	struct stat st;
+	if(fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+		void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if(p != MAP_FAILED) {
+			madvise(p, st.st_size, MADV_SEQUENTIAL);
+			mapped = true;
+			begin = (const char*)p;
+			length = st.st_size;
+		}
+	}
+
+	// not mappable (e.g. a pipe), read into a buffer instead
+	if(!mapped) {
+		char chunk[1 << 16];
+		ssize_t k;
+		while((k = read(fd, chunk, sizeof(chunk))) > 0) {
+			buffer.insert(buffer.end(), chunk, chunk+k);
+		}
+		begin = buffer.data();
+		length = buffer.size();
+	}
+	close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+	if(mapped)
+		munmap((void*)begin, length);
+}
+
+const char* LineReader::findLineEnd(const char* p) const
+{
+	const char* e = (const char*)memchr(p, '\n', end-p);
+	return (e == nullptr) ? end : e;
+}
+
+bool LineReader::readDouble(double& v)
+{
+	static const double pow10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15 };
+
+	skipSpace();
+
+	// plain decimals with at most 15 digits are exact as integer divided by a power of ten, which
+	// gives the same correctly rounded value as strtod
+	const char* p = pos;
+	bool neg = false;
+	if(p != lineEnd && (*p == '-' || *p == '+')) {
+		neg = (*p == '-');
+		p++;
+	}
+	long x = 0;
+	int nDigits = 0, nFrac = 0;
+	for(; p != lineEnd && isDigit(*p); p++, nDigits++) {
+		x = 10*x + (*p - '0');
+	}
+	if(p != lineEnd && *p == '.') {
+		for(p++; p != lineEnd && isDigit(*p); p++, nFrac++) {
+			x = 10*x + (*p - '0');
+		}
+	}
+	if(nDigits + nFrac > 0 && nDigits + nFrac <= 15 && (p == lineEnd || isSpace(*p))) {
+		const double d = (double)x / pow10[nFrac];
+		v = neg ? -d : d;
+		pos = p;
+		return true;
+	}
+
+	// anything else (exponents, long mantissas, inf, ...) is left to strtod
+	char buf[256];
+	const size_t len = std::min((size_t)(lineEnd-pos), sizeof(buf)-1);
+	memcpy(buf, pos, len);
+	buf[len] = '\0';
+	char* e;
+	const double d = strtod(buf, &e);
+	if(e == buf) return false;
+	v = d;
+	pos += e-buf;
+	return true;
+}
@@ -0,0 +1,88 @@
+/**
+ * \file   reopt.cpp
+ * \brief  state of a solve reused to solve the instance again after changes of prizes and costs
+ *
+ * \author Martin Luipersbeck
+ * \date   2026-10-17
+ */
+
+#include "reopt.h"
+#include "reader.h"
+#include "options.h"
+#include "util.h"
+#include "stats.h"
+
+#include <math.h>
+
+uint64_t structureHash(const Inst& inst)
+{
+	uint64_t h = 1469598103934665603ULL;
+	auto mix = [&h](int64_t x) { h = (h ^ (uint64_t)x) * 1099511628211ULL; };
+	mix(inst.n); mix(inst.m); mix(inst.r); mix(inst.bigM);
+	mix(inst.isAsym); mix(inst.isMWCS);
+	for(int ij = 0; ij < inst.m; ij++) {
+		mix(inst.fe0[ij]);
+		if(inst.fe0[ij]) continue;
+		mix(inst.tail[ij]); mix(inst.head[ij]);
+	}
+	for(int i = 0; i < inst.n; i++) {
+		mix(inst.f0[i]); mix(inst.f1[i]);
+	}
+	return h;
+}
+
+int applyDelta(Inst& inst, const char* fn)
+{
+	const bool bPrizes = (params.type.compare("pcstp") == 0);
+	if(!bPrizes && params.type.compare("stp") != 0) {
+		EXIT("error: delta files are only supported for pcstp and stp instances\n");
+	}
+
+	MappedFile file(fn);
+	if(!file.isOpen()) {
+		EXIT("error: file not found: %s\n", fn);
+	}
+
+	auto weight = [&](double w) -> weight_t {
+		if(!(w >= 0.0)) {
+			EXIT("error: negative weight in delta file %s\n", fn);
+		}
+		if(!inst.isInt) return (weight_t)round(w * params.precision);
+		if(floor(w) != w) {
+			EXIT("error: delta file %s changes an integral instance to a fractional one\n", fn);
+		}
+		return (weight_t)w;
+	};
+
+	LineReader in(file.data(), file.data() + file.size());
+	int nChanges = 0;
+	while(in.next()) {
+		int i, j;
+		double w;
+		if(in.match("E") && in.readInt(i) && in.readInt(j) && in.readDouble(w)) {
+			i--; j--;
+			if(i < 0 || i >= inst.n || j < 0 || j >= inst.n) {
+				EXIT("error: delta file %s refers to an invalid edge %d %d\n", fn, i+1, j+1);
+			}
+			const weight_t c = weight(w);
+			int found = 0;
+			for(int ij : inst.dout[i]) if(inst.head[ij] == j) { inst.c[ij] = c; found++; }
+			for(int ji : inst.dout[j]) if(inst.head[ji] == i) { inst.c[ji] = c; found++; }
+			if(found == 0) {
+				EXIT("error: delta file %s refers to an invalid edge %d %d\n", fn, i+1, j+1);
+			}
+			nChanges++;
+		} else if(bPrizes && in.match("TP") && in.readInt(i) && in.readDouble(w)) {
+			i--;
+			if(i < 0 || i >= inst.n || inst.f1[i]) {
+				EXIT("error: delta file %s changes the prize of an invalid node %d\n", fn, i+1);
+			}
+			inst.p[i] = weight(w);
+			nChanges++;
+		}
+	}
+
+	finalizeInst(inst);
+	stats.initial = inst.countInstSize();
+	return nChanges;
+}
@@ -0,0 +1,294 @@
+/**
+ * \file   server.cpp
+ * \brief  solver daemon on a unix domain socket
+ *
+ * Requests and responses are lines, except for the instance and solution data that follow them.
+ * A client sends
+ *
+ *   SOLVE <nbytes> [options]
+ *
+ * followed by nbytes of instance data: the content of an instance file of the type given by
+ * --type, or of a binary cache file (.stpb). The options are given in command line form, e.g.
+ * --timelimit 10, and override the options of the daemon. The daemon answers with
+ *
+ *   INCUMBENT <objective> <time>         for each new incumbent while solving
+ *   RESULT <status> <objective> <lower bound> <gap> <time>
+ *   STATS <row of the --stats file>
+ *   SOLUTION <nbytes>                    followed by nbytes of the solution file (-o)
+ *   END
+ *
+ * or with ERROR <message> and END if the request fails. Sending CANCEL while a request is solved,
+ * or closing the connection, stops the solve. A connection may send any number of requests.
+ *
+ * \author Martin Luipersbeck
+ * \date   2026-10-17
+ */
+
+#include "server.h"
+#include "dapcstp.h"
+#include "def.h"
+#include "options.h"
+#include "parallel.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <poll.h>
+#include <errno.h>
+#include <string.h>
+
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <sstream>
+#include <condition_variable>
+
+using namespace std;
+
+// client connection, input is buffered in in until it is processed
+class Connection
+{
+public:
+	explicit Connection(int fd) : fd(fd) {}
+	~Connection() { close(fd); }
+
+	int  getFd() const    { return fd; }
+	bool isClosed() const { return closed; }
+
+	// receives available input, returns false if the client disconnected
+	bool receive()
+	{
+		char buf[1 << 16];
+		ssize_t n;
+		while((n = recv(fd, buf, sizeof(buf), 0)) < 0 && errno == EINTR);
+		if(n <= 0) {
+			closed = true;
+			return false;
+		}
+		in.append(buf, n);
+		return true;
+	}
+
+	bool readLine(string& line)
+	{
+		size_t pos;
+		while((pos = in.find('\n')) == string::npos) {
+			if(in.size() > maxLine || !receive()) return false;
+		}
+		line.assign(in, 0, pos);
+		if(!line.empty() && line.back() == '\r') line.pop_back();
+		in.erase(0, pos+1);
+		return true;
+	}
+
+	bool readBytes(size_t n, string& data)
+	{
+		while(in.size() < n) {
+			if(!receive()) return false;
+		}
+		data.assign(in, 0, n);
+		in.erase(0, n);
+		return true;
+	}
+
+	// consumes a CANCEL line at the start of the input
+	bool takeCancel()
+	{
+		if(in.compare(0, 7, "CANCEL\n") == 0) {
+			in.erase(0, 7);
+			return true;
+		}
+		return false;
+	}
+
+	// writes are serialized, since incumbents are reported from the solving threads
+	void write(const string& s)
+	{
+		lock_guard<mutex> lock(mtxOut);
+		for(size_t pos = 0; pos < s.size() && !closed; ) {
+			const ssize_t n = send(fd, s.data() + pos, s.size() - pos, MSG_NOSIGNAL);
+			if(n < 0 && errno == EINTR) continue;
+			if(n <= 0) closed = true;
+			else pos += n;
+		}
+	}
+
+private:
+	static const size_t maxLine = 1 << 16;
+
+	int fd;
+	string in;
+	mutex mtxOut;
+	atomic<bool> closed{false};
+};
+
+// queue of accepted connections, accepting blocks while it is full
+class ConnectionQueue
+{
+public:
+	explicit ConnectionQueue(size_t capacity) : capacity(capacity) {}
+
+	void push(int fd)
+	{
+		unique_lock<mutex> lock(mtx);
+		cvFull.wait(lock, [this]() { return fds.size() < capacity; });
+		fds.push_back(fd);
+		cvEmpty.notify_one();
+	}
+
+	// returns -1 once the queue is closed
+	int pop()
+	{
+		unique_lock<mutex> lock(mtx);
+		cvEmpty.wait(lock, [this]() { return !fds.empty() || closed; });
+		if(closed) return -1;
+		const int fd = fds.front();
+		fds.pop_front();
+		cvFull.notify_one();
+		return fd;
+	}
+
+	// wakes up the waiting workers, connections not yet taken are closed
+	void close()
+	{
+		lock_guard<mutex> lock(mtx);
+		closed = true;
+		for(int fd : fds) ::close(fd);
+		fds.clear();
+		cvEmpty.notify_all();
+	}
+
+private:
+	size_t capacity;
+	bool closed = false;
+	deque<int> fds;
+	mutex mtx;
+	condition_variable cvEmpty, cvFull;
+};
+
+static const char* statusName(dapcstp::Status s)
+{
+	switch(s) {
+		case dapcstp::Status::Optimal:   return "optimal";
+		case dapcstp::Status::TimeLimit: return "timelimit";
+		case dapcstp::Status::NodeLimit: return "nodelimit";
+		case dapcstp::Status::MemLimit:  return "memlimit";
+		case dapcstp::Status::Cancelled: return "cancelled";
+		default:                         return "error";
+	}
+}
+
+// solves the instance of a SOLVE request, while a second thread watches the connection for CANCEL
+static void solveRequest(Connection& conn, const vector<string>& defaults, istringstream& request)
+{
+	size_t size;
+	if(!(request >> size)) {
+		conn.write("ERROR invalid request, expected: SOLVE <nbytes> [options]\nEND\n");
+		return;
+	}
+
+	dapcstp::Solver solver;
+	vector<string> args = defaults;
+	string arg;
+	while(request >> arg) args.push_back(arg);
+	solver.setArguments(args);
+
+	string data;
+	if(!conn.readBytes(size, data))
+		return;
+
+	atomic<bool> cancel{false}, done{false};
+	solver.setCancelFlag(&cancel);
+	solver.setIncumbentCallback([&conn](double obj, double time) {
+		conn.write(formatMessage("INCUMBENT %.6lf %.3lf\n", obj, time));
+	});
+
+	thread watcher([&]() {
+		while(!done && !cancel) {
+			pollfd pfd = { conn.getFd(), POLLIN, 0 };
+			if(poll(&pfd, 1, 100) > 0 && (!conn.receive() || conn.takeCancel()))
+				cancel = true;
+		}
+	});
+	dapcstp::Result res = solver.solve(data.data(), data.size());
+	done = true;
+	watcher.join();
+
+	string out;
+	if(res.status == dapcstp::Status::Error) {
+		appendf(out, "ERROR %s\n", res.error.c_str());
+	} else {
+		appendf(out, "RESULT %s %.6lf %.6lf %.6lf %.3lf\n", statusName(res.status), res.objective, res.lowerBound, res.gap, res.stats.time);
+		appendf(out, "STATS %s", res.statsLine.c_str());
+		appendf(out, "SOLUTION %zu\n", res.solution.size());
+		out += res.solution;
+	}
+	out += "END\n";
+	conn.write(out);
+}
+
+static void serveConnection(int fd, const vector<string>& defaults)
+{
+	Connection conn(fd);
+	string line;
+	while(!conn.isClosed() && conn.readLine(line)) {
+		istringstream request(line);
+		string cmd;
+		request >> cmd;
+		if(cmd == "SOLVE") {
+			solveRequest(conn, defaults, request);
+		} else if(!cmd.empty() && cmd != "CANCEL") {
+			// a CANCEL arriving after its request was finished is ignored
+			conn.write("ERROR unknown request: " + cmd + "\nEND\n");
+		}
+	}
+}
+
+void serve(const char* path, int argc, char* argv[])
+{
+	sockaddr_un addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	if(strlen(path) >= sizeof(addr.sun_path)) {
+		EXIT("error: socket path too long: %s\n", path);
+	}
+	strcpy(addr.sun_path, path);
+
+	const int sfd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if(sfd < 0) {
+		EXIT("error: creating socket: %s\n", strerror(errno));
+	}
+	unlink(path);
+	if(bind(sfd, (sockaddr*)&addr, sizeof(addr)) < 0 || listen(sfd, 64) < 0) {
+		EXIT("error: binding socket %s: %s\n", path, strerror(errno));
+	}
+
+	const int nWorkers = max(1, params.jobs);
+	const vector<string> defaults(argv+1, argv+argc);
+	ConnectionQueue queue(4 * nWorkers);
+
+	printf("[ %sserve%s  ] listening on %s with %d worker(s)\n", GREEN, NORMAL, path, nWorkers);
+	fflush(stdout);
+
+	// thread 0 accepts connections, the workers are kept for the lifetime of the daemon, so the
+	// thread-local dual ascent workspaces remain allocated between requests
+	runThreads(nWorkers + 1, [&](int i) {
+		if(i == 0) {
+			// on an error the workers stop after their current request, so that it is reported
+			try {
+				for(;;) {
+					const int fd = accept(sfd, NULL, NULL);
+					if(fd >= 0) queue.push(fd);
+					else if(errno != EINTR && errno != ECONNABORTED) EXIT("error: accepting connection: %s\n", strerror(errno));
+				}
+			} catch(...) {
+				queue.close();
+				throw;
+			}
+		}
+		for(int fd; (fd = queue.pop()) >= 0; ) {
+			serveConnection(fd, defaults);
+		}
+	});
+}
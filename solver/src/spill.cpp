@@ -0,0 +1,198 @@
+/**
+ * \file   spill.cpp
+ * \brief  temporary file holding open B&B nodes moved out of memory
+ *
+ * \author Martin Luipersbeck
+ * \date   2026-10-17
+ */
+
+#include "spill.h"
+#include "stats.h"
+
+#include <string.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <boost/filesystem.hpp>
+
+// records are the raw bytes of their fields, vectors preceded by their length
+template<typename T>
+static void put(vector<char>& buf, const T& x)
+{
+	const char* p = (const char*)&x;
+	buf.insert(buf.end(), p, p+sizeof(T));
+}
+
+static void put(vector<char>& buf, const vector<int>& v)
+{
+	put(buf, v.size());
+	const char* p = (const char*)v.data();
+	buf.insert(buf.end(), p, p+v.size()*sizeof(int));
+}
+
+template<typename T>
+static void put(vector<char>& buf, const vector<pair<int,T>>& v)
+{
+	put(buf, v.size());
+	for(auto& e : v) {
+		put(buf, e.first);
+		put(buf, e.second);
+	}
+}
+
+static void put(vector<char>& buf, const InstDiff::ListEntries& l)
+{
+	put(buf, l.idx); put(buf, l.beg); put(buf, l.data);
+}
+
+template<typename T>
+static void get(const char*& pos, T& x)
+{
+	memcpy(&x, pos, sizeof(T));
+	pos += sizeof(T);
+}
+
+static void get(const char*& pos, vector<int>& v)
+{
+	size_t k;
+	get(pos, k);
+	v.resize(k);
+	memcpy(v.data(), pos, k*sizeof(int));
+	pos += k*sizeof(int);
+}
+
+static void get(const char*& pos, InstDiff::ListEntries& l)
+{
+	get(pos, l.idx); get(pos, l.beg); get(pos, l.data);
+}
+
+template<typename T>
+static void get(const char*& pos, vector<pair<int,T>>& v)
+{
+	size_t k;
+	get(pos, k);
+	v.resize(k);
+	for(auto& e : v) {
+		get(pos, e.first);
+		get(pos, e.second);
+	}
+}
+
+NodeSpill::NodeSpill(const string& dir) : dir(dir)
+{
+}
+
+bool NodeSpill::open()
+{
+	lock_guard<mutex> lock(mtx);
+	if(fd >= 0 || failed)
+		return !failed;
+
+	boost::system::error_code ec;
+	const string tmp = dir.empty() ? boost::filesystem::temp_directory_path(ec).string() : dir;
+	if(!ec) {
+		vector<char> name(tmp.begin(), tmp.end());
+		const string suffix = "/dapcstp-spill-XXXXXX";
+		name.insert(name.end(), suffix.begin(), suffix.end());
+		name.push_back('\0');
+		fd = mkstemp(name.data());
+		// the file is removed as soon as it is closed
+		if(fd >= 0)
+			unlink(name.data());
+	}
+	if(fd < 0) {
+		fprintf(stderr, "warning: could not create spill file in %s, spilling disabled\n", dir.empty() ? "the temporary directory" : dir.c_str());
+		failed = true;
+	}
+	return !failed;
+}
+
+NodeSpill::~NodeSpill()
+{
+	if(fd >= 0)
+		close(fd);
+}
+
+bool NodeSpill::spill(BBNode* b)
+{
+	if(b->inst != nullptr || b->spillPos >= 0 || (b->diff == nullptr && b->duals == nullptr))
+		return false;
+
+	vector<char> buf;
+	put(buf, (char)(b->diff != nullptr));
+	if(b->diff != nullptr) {
+		const InstDiff& d = *b->diff;
+		put(buf, d.din); put(buf, d.dout); put(buf, d.bmna); put(buf, d.bmaa);
+		put(buf, d.tail); put(buf, d.head); put(buf, d.opposite); put(buf, d.pin); put(buf, d.pout);
+		put(buf, d.f0); put(buf, d.f1); put(buf, d.fe0); put(buf, d.T);
+		put(buf, d.c); put(buf, d.p);
+		put(buf, d.offset); put(buf, d.bigM);
+		put(buf, d.t); put(buf, d.r); put(buf, d.arcMoves);
+	}
+	put(buf, (char)(b->duals != nullptr));
+	if(b->duals != nullptr) {
+		const DualState& s = *b->duals;
+		put(buf, s.arcs); put(buf, s.nodes);
+		put(buf, s.lb); put(buf, s.arcMoves); put(buf, s.structure);
+	}
+
+	int64_t pos;
+	{
+		lock_guard<mutex> lock(mtx);
+		pos = end;
+		end += (int64_t)buf.size();
+	}
+	for(size_t k = 0; k < buf.size(); ) {
+		const ssize_t w = pwrite(fd, buf.data()+k, buf.size()-k, pos+k);
+		if(w <= 0) {
+			EXIT("error: could not write spill file\n");
+		}
+		k += w;
+	}
+
+	b->spillPos = pos;
+	b->spillSize = (int64_t)buf.size();
+	b->diff.reset();
+	b->duals.reset();
+	stats.spilled++;
+	return true;
+}
+
+void NodeSpill::unspill(BBNode* b)
+{
+	if(b->spillPos < 0)
+		return;
+
+	vector<char> buf(b->spillSize);
+	for(size_t k = 0; k < buf.size(); ) {
+		const ssize_t r = pread(fd, buf.data()+k, buf.size()-k, b->spillPos+k);
+		if(r <= 0) {
+			EXIT("error: could not read spill file\n");
+		}
+		k += r;
+	}
+
+	const char* pos = buf.data();
+	char bDiff, bDuals;
+	get(pos, bDiff);
+	if(bDiff) {
+		auto d = make_shared<InstDiff>();
+		get(pos, d->din); get(pos, d->dout); get(pos, d->bmna); get(pos, d->bmaa);
+		get(pos, d->tail); get(pos, d->head); get(pos, d->opposite); get(pos, d->pin); get(pos, d->pout);
+		get(pos, d->f0); get(pos, d->f1); get(pos, d->fe0); get(pos, d->T);
+		get(pos, d->c); get(pos, d->p);
+		get(pos, d->offset); get(pos, d->bigM);
+		get(pos, d->t); get(pos, d->r); get(pos, d->arcMoves);
+		b->diff = d;
+	}
+	get(pos, bDuals);
+	if(bDuals) {
+		auto s = make_shared<DualState>();
+		get(pos, s->arcs); get(pos, s->nodes);
+		get(pos, s->lb); get(pos, s->arcMoves); get(pos, s->structure);
+		b->duals = s;
+	}
+
+	b->spillPos = -1;
+	b->spillSize = 0;
+	stats.unspilled++;
+}
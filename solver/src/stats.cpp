@@ -9,96 +9,104 @@
 #include "stats.h"
 #include "options.h"
 #include <stdio.h>
+#include <stdarg.h>
 #include <boost/filesystem.hpp>
 
-ProgramStats::Stats stats;
+thread_local ProgramStats::Stats stats;
 
-void ProgramStats::writeStats(const char* file)
+string ProgramStats::statsLine()
 {
-	FILE* fp;
-	if((fp=fopen(file, "w")) == NULL)
-		EXIT("error writing stats: %s\n", file);
-
+	string line;
 	string dirname = boost::filesystem::path(params.file).parent_path().filename().string();
 
 	// instance properties
-	fprintf(fp, "%s;", stats.name.c_str());
-	fprintf(fp, "%s;", dirname.c_str());
-	fprintf(fp, "%d;", (int)stats.isInt);
-	fprintf(fp, "%d;", (int)stats.isAsym);
-	fprintf(fp, "%d;", stats.initial.n);
-	fprintf(fp, "%d;", stats.initial.m);
-	fprintf(fp, "%d;", stats.initial.t);
-	fprintf(fp, "%d;", stats.initial.tr);
-	fprintf(fp, "%d;", stats.initial.f1);
+	appendf(line, "%s;", stats.name.c_str());
+	appendf(line, "%s;", dirname.c_str());
+	appendf(line, "%d;", (int)stats.isInt);
+	appendf(line, "%d;", (int)stats.isAsym);
+	appendf(line, "%d;", stats.initial.n);
+	appendf(line, "%d;", stats.initial.m);
+	appendf(line, "%d;", stats.initial.t);
+	appendf(line, "%d;", stats.initial.tr);
+	appendf(line, "%d;", stats.initial.f1);
 
 	// initial preprocessing
-	fprintf(fp, "%d;", stats.prep.n);
-	fprintf(fp, "%d;", stats.prep.m);
-	fprintf(fp, "%d;", stats.prep.t);
-	fprintf(fp, "%d;", stats.prep.tr);
-	fprintf(fp, "%d;", stats.prep.f1);
-	fprintf(fp, "%.3lf;", stats.preptime);
+	appendf(line, "%d;", stats.prep.n);
+	appendf(line, "%d;", stats.prep.m);
+	appendf(line, "%d;", stats.prep.t);
+	appendf(line, "%d;", stats.prep.tr);
+	appendf(line, "%d;", stats.prep.f1);
+	appendf(line, "%.3lf;", stats.preptime);
 
 	// root node
-	fprintf(fp, "%.6lf;", stats.rootlb);
-	fprintf(fp, "%.6lf;", stats.rootub);
-	fprintf(fp, "%.6lf;", stats.rootgap);
-	fprintf(fp, "%d;",    stats.roots);
-	fprintf(fp, "%d;",    stats.proots);
-	fprintf(fp, "%d;",    stats.oroots);
-	fprintf(fp, "%.3lf;", stats.rootavgn);
-	fprintf(fp, "%.3lf;", stats.rootavgm);
-	fprintf(fp, "%.3lf;", stats.rootavgt);
-	fprintf(fp, "%.3lf;", stats.rootavgtr);
-	fprintf(fp, "%.3lf;", stats.rootavgf1);
-	fprintf(fp, "%.3lf;", stats.roottime);
+	appendf(line, "%.6lf;", stats.rootlb);
+	appendf(line, "%.6lf;", stats.rootub);
+	appendf(line, "%.6lf;", stats.rootgap);
+	appendf(line, "%d;",    stats.roots);
+	appendf(line, "%d;",    stats.proots);
+	appendf(line, "%d;",    stats.oroots);
+	appendf(line, "%.3lf;", stats.rootavgn);
+	appendf(line, "%.3lf;", stats.rootavgm);
+	appendf(line, "%.3lf;", stats.rootavgt);
+	appendf(line, "%.3lf;", stats.rootavgtr);
+	appendf(line, "%.3lf;", stats.rootavgf1);
+	appendf(line, "%.3lf;", stats.roottime);
 
 	// B&B
-	fprintf(fp, "%d;",    stats.bbnodes);
-	fprintf(fp, "%.6lf;", stats.lb);
-	fprintf(fp, "%.6lf;", stats.ub);
-	fprintf(fp, "%.6lf;", stats.gap);
+	appendf(line, "%d;",    stats.bbnodes);
+	appendf(line, "%.6lf;", stats.lb);
+	appendf(line, "%.6lf;", stats.ub);
+	appendf(line, "%.6lf;", stats.gap);
 
 	// prep
-	fprintf(fp, "%d;", (int)stats.d1);
-	fprintf(fp, "%d;", (int)stats.d2);
-	fprintf(fp, "%d;", (int)stats.ma);
-	fprintf(fp, "%d;", (int)stats.ms);
-	fprintf(fp, "%d;", (int)stats.ss);
-	fprintf(fp, "%d;", (int)stats.lc);
-	fprintf(fp, "%d;", (int)stats.nr);
-	fprintf(fp, "%d;", (int)stats.boundbased);
-
-	fprintf(fp, "%.3lf;", stats.heurtime);
-	fprintf(fp, "%.3lf;", stats.heurbbtime);
-	fprintf(fp, "%.3lf;", stats.timeBest);
-	fprintf(fp, "%.3lf;", stats.time);
+	appendf(line, "%d;", (int)stats.d1);
+	appendf(line, "%d;", (int)stats.d2);
+	appendf(line, "%d;", (int)stats.ma);
+	appendf(line, "%d;", (int)stats.ms);
+	appendf(line, "%d;", (int)stats.ss);
+	appendf(line, "%d;", (int)stats.lc);
+	appendf(line, "%d;", (int)stats.nr);
+	appendf(line, "%d;", (int)stats.boundbased);
+
+	appendf(line, "%.3lf;", stats.heurtime);
+	appendf(line, "%.3lf;", stats.heurbbtime);
+	appendf(line, "%.3lf;", stats.timeBest);
+	appendf(line, "%.3lf;", stats.time);
 	
-	fprintf(fp, "%d;", stats.memout);
+	appendf(line, "%d;", stats.memout);
 
 	// paramters
-	fprintf(fp, "%d;", (int)params.heursupportG);
-	fprintf(fp, "%d;", (int)params.heurbb);
-	fprintf(fp, "%.6lf;", params.heureps);
-	fprintf(fp, "%d;", (int)params.heurroots);
-	fprintf(fp, "%d;", (int)params.heurbbtime);
-	fprintf(fp, "%d;", (int)params.perturbedheur);
-	fprintf(fp, "%d;", (int)params.daiterations);
-	fprintf(fp, "%d;", (int)params.nodeselect);
-	fprintf(fp, "%d;", (int)params.branchtype);
-	fprintf(fp, "%d;", (int)params.daguide);
-
-	fprintf(fp, "%d;", (int)params.d1);
-	fprintf(fp, "%d;", (int)params.d2);
-	fprintf(fp, "%d;", (int)params.ma);
-	fprintf(fp, "%d;", (int)params.ms);
-	fprintf(fp, "%d;", (int)params.ss);
-	fprintf(fp, "%d;", (int)params.lc);
-	fprintf(fp, "%d;", (int)params.nr);
-	fprintf(fp, "%d",  (int)params.boundbased);
-	fprintf(fp, "\n");
+	appendf(line, "%d;", (int)params.heursupportG);
+	appendf(line, "%d;", (int)params.heurbb);
+	appendf(line, "%.6lf;", params.heureps);
+	appendf(line, "%d;", (int)params.heurroots);
+	appendf(line, "%d;", (int)params.heurbbtime);
+	appendf(line, "%d;", (int)params.perturbedheur);
+	appendf(line, "%d;", (int)params.daiterations);
+	appendf(line, "%d;", (int)params.nodeselect);
+	appendf(line, "%d;", (int)params.branchtype);
+	appendf(line, "%d;", (int)params.daguide);
+
+	appendf(line, "%d;", (int)params.d1);
+	appendf(line, "%d;", (int)params.d2);
+	appendf(line, "%d;", (int)params.ma);
+	appendf(line, "%d;", (int)params.ms);
+	appendf(line, "%d;", (int)params.ss);
+	appendf(line, "%d;", (int)params.lc);
+	appendf(line, "%d;", (int)params.nr);
+	appendf(line, "%d",  (int)params.boundbased);
+	appendf(line, "\n");
+
+	return line;
+}
 
+void ProgramStats::writeStats(const char* file)
+{
+	FILE* fp;
+	if((fp=fopen(file, "w")) == NULL)
+		EXIT("error writing stats: %s\n", file);
+
+	fputs(statsLine().c_str(), fp);
 	fclose(fp);
 }
 
@@ -128,3 +136,18 @@ void ProgramStats::averageRootNodeStats(int nRootsOpen)
 	stats.rootavgtr /= nRootsOpen;
 	stats.rootavgf1 /= nRootsOpen;
 }
+
+void ProgramStats::mergeStats(const Stats& s)
+{
+	stats.d1 += s.d1;
+	stats.d2 += s.d2;
+	stats.ma += s.ma;
+	stats.ms += s.ms;
+	stats.ss += s.ss;
+	stats.lc += s.lc;
+	stats.nr += s.nr;
+	stats.boundbased += s.boundbased;
+	stats.spilled += s.spilled;
+	stats.unspilled += s.unspilled;
+	stats.probes += s.probes;
+}
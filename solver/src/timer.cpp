@@ -12,7 +12,7 @@
 using namespace std;
 using namespace boost::timer;
 
-const Timer Timer::total(true);
+thread_local Timer Timer::total(true);
 
 void Timer::start()
 {
@@ -33,6 +33,12 @@ const CPUTime Timer::elapsed() const
 	return CPUTime(timer.elapsed());
 }
 
+void Timer::assign(const Timer& t)
+{
+	lock_guard<mutex> lock(atomic);
+	timer = t.timer;
+}
+
 void Timer::pause()
 {
 	unique_lock<mutex>(atomic);
@@ -15,38 +15,110 @@ using namespace std;
 #include "options.h"
 #include "sol.h"
 #include "ds.h"
+#include "reader.h"
+#include "cache.h"
+#include "parallel.h"
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stack>
 #include <boost/filesystem.hpp>
-#include <sys/resource.h>
 #include <boost/pending/disjoint_sets.hpp>
 
 #include "stats.h"
 
+static thread_local random_data rndData;
+static thread_local char rndState[128];
+static thread_local bool rndSeeded = false;
+
+void seedRandom(unsigned seed)
+{
+	// a state of 128 bytes corresponds to the generator used by rand()
+	memset(&rndData, 0, sizeof(rndData));
+	initstate_r(seed, rndState, sizeof(rndState), &rndData);
+	rndSeeded = true;
+}
+
+int randomInt()
+{
+	if(!rndSeeded) seedRandom(params.seed);
+	int32_t x;
+	random_r(&rndData, &x);
+	return x;
+}
+
 Inst load(const char* fn)
 {
 	Inst inst;
+	if(loadCache(fn, inst)) {
+		stats.initial = inst.countInstSize();
+		stats.bidirect = bidirectRatio(inst);
+		return inst;
+	}
+
+	MappedFile file(fn);
+	if(!file.isOpen()) {
+		EXIT("error: file not found: %s\n", fn);
+	}
+	inst = loadText(file.data(), file.data() + file.size());
+
+	if(params.cache) {
+		writeCache(fn, inst);
+	}
+
+	return inst;
+}
+
+Inst loadText(const char* begin, const char* end)
+{
 	// all instances are loaded in their APCSTP representation
+	Inst inst;
 	if(params.type.compare("nwstp") == 0 || params.type.compare("stp") == 0) {
-		inst = loadNWSTP(fn);
+		inst = loadNWSTP(begin, end);
 	} else if(params.type.compare("mwcs") == 0) {
-		inst = loadMWCS(fn);
+		inst = loadMWCS(begin, end);
 	} else if(params.type.compare("pcstp") == 0){
-		inst = loadPCSTP(fn);
+		inst = loadPCSTP(begin, end);
 	} else {
 		EXIT("error: specified problem type unknown: %s\n", params.type.c_str());
 	}
+	if(inst.n == 0) {
+		EXIT("error: instance without nodes\n");
+	}
+
+	finalizeInst(inst);
+
+	stats.initial = inst.countInstSize();
+	stats.bidirect = bidirectRatio(inst);
+
+	return inst;
+}
+
+Inst loadData(const char* data, size_t size)
+{
+	if(!isCacheData(data, size)) {
+		return loadText(data, data + size);
+	}
+
+	Inst inst;
+	if(!loadCacheData(data, size, inst)) {
+		EXIT("error: binary instance is invalid or was written for a different problem type or precision\n");
+	}
+	stats.initial = inst.countInstSize();
+	stats.bidirect = bidirectRatio(inst);
+	return inst;
+}
 
+void finalizeInst(Inst& inst)
+{
 	inst.t = 0;
 	for(int i = 0; i < inst.n; i++) {
 		if(inst.p[i] > 0 || inst.f1[i]) inst.t++;
 		inst.T[i] = (inst.p[i] != 0);
 	}
 
-	stats.initial = inst.countInstSize();
-
 	// associates the anti-parallel arc to each arc if it exists (-1 otherwise)
-	int antiparallelArcs = 0;
 	if(inst.isAsym) {
 		for(int ij = 0; ij < inst.m; ij++)
 			inst.opposite[ij] = -1;
@@ -63,6 +135,14 @@ Inst load(const char* fn)
 				}
 			}
 		}
+	}
+}
+
+// computes the ratio of bidirected edges / arcs that have an antiparallel counterpart
+double bidirectRatio(Inst& inst)
+{
+	int antiparallelArcs = 0;
+	if(inst.isAsym) {
 		for(int ij = 0; ij < inst.m; ij++) {
 			if(inst.opposite[ij] == -1) continue;
 			antiparallelArcs++;
@@ -71,91 +151,241 @@ Inst load(const char* fn)
 		antiparallelArcs = inst.m;
 	}
 
-	// compute the ratio of bidirected edges / arcs that have an antiparallel counterpart
-	stats.bidirect = (double)antiparallelArcs/(2*inst.m-antiparallelArcs);
-
-	return inst;
+	return (double)antiparallelArcs/(2*inst.m-antiparallelArcs);
 }
 
-Inst loadMWCS(const char* fn)
+// kinds of lines recognized by the loaders
+enum LineKind : char {
+	L_NONE, L_NODES, L_EDGES, L_ARCS, L_TERMINALS, L_FIXED, L_ROOT,
+	L_EDGE, L_ARC, L_TERMINAL, L_NODEWEIGHT, L_END
+};
+
+// line of an instance file parsed by the line parser of a loader
+struct InstLine {
+	LineKind kind;
+	int v1, v2;
+	double w;
+};
+
+// rejects lines referring to undeclared nodes or exceeding the declared number of edges, so that a
+// malformed instance fails to load instead of corrupting the instance
+class LineCheck
 {
-	FILE *fp;
-	char buf[256];
-	int n, m, t, v1, v2, r;
-	double w, prize;
-	int ij = 0;
+public:
+	void operator()(const InstLine& l)
+	{
+		switch(l.kind) {
+		case L_NODES:
+			if(l.v1 <= 0 || n > 0) EXIT("error: invalid number of nodes %d\n", l.v1);
+			n = l.v1;
+			break;
+		case L_EDGES:
+		case L_ARCS:
+			if(l.v1 < 0 || m >= 0) EXIT("error: invalid number of edges %d\n", l.v1);
+			m = (l.kind == L_EDGES) ? 2*(long)l.v1 : l.v1;
+			break;
+		case L_EDGE:
+		case L_ARC:
+			node(l.v1);
+			node(l.v2);
+			arcs += (l.kind == L_EDGE) ? 2 : 1;
+			if(arcs > m) EXIT("error: more edges than declared\n");
+			break;
+		case L_TERMINAL:
+		case L_ROOT:
+			node(l.v1);
+			break;
+		case L_NODEWEIGHT:
+			if(++weights > n) EXIT("error: more node weights than nodes\n");
+			break;
+		default:
+			break;
+		}
+	}
 
-	if((fp=fopen(fn, "r")) == NULL) {
-		EXIT("error: file not found: %s\n", fn);
+private:
+	int n = 0, weights = 0;
+	long m = -1, arcs = 0;
+
+	void node(int i)
+	{
+		if(i < 1 || i > n) EXIT("error: invalid node %d\n", i);
+	}
+};
+
+// parses the lines of the content of an instance file with parse(), which returns the kind of the
+// line, and passes the recognized lines to apply() in file order. With --threads > 1, large files are
+// split into line-aligned chunks that are parsed in parallel before applying their lines.
+template<typename Parse, typename Apply>
+static void forEachLine(const char* begin, const char* end, Parse parse, Apply apply)
+{
+	const size_t size = end - begin;
+	const size_t minChunk = 1 << 20;
+	const int nThreads = (int)min<size_t>(max(params.threads, 1), max<size_t>(size / minChunk, 1));
+	if(nThreads == 1) {
+		LineReader in(begin, end);
+		LineCheck check;
+		InstLine l;
+		while(in.next()) {
+			if((l.kind = parse(in, l)) != L_NONE) {
+				check(l);
+				apply(l);
+			}
+		}
+		return;
+	}
+
+	// chunk boundaries are moved behind the end of the line they fall into
+	const int nChunks = 4*nThreads;
+	vector<const char*> bound(nChunks+1, end);
+	bound[0] = begin;
+	for(int c = 1; c < nChunks; c++) {
+		const char* p = max(begin + size / nChunks * c, bound[c-1]);
+		const char* e = (const char*)memchr(p, '\n', end-p);
+		bound[c] = (e == nullptr) ? end : e+1;
 	}
 
+	vector<vector<InstLine>> lines(nChunks);
+	runThreads(nThreads, [&](int t) {
+		for(int c = t; c < nChunks; c += nThreads) {
+			LineReader in(bound[c], bound[c+1]);
+			InstLine l;
+			while(in.next()) {
+				if((l.kind = parse(in, l)) != L_NONE) lines[c].push_back(l);
+			}
+		}
+	});
+
+	LineCheck check;
+	for(auto& chunk : lines) {
+		for(const InstLine& l : chunk) {
+			check(l);
+			apply(l);
+		}
+		vector<InstLine>().swap(chunk);
+	}
+}
+
+static LineKind parseMWCSLine(LineReader& in, InstLine& l)
+{
+	switch(in.first()) {
+	case 'N':
+		if(in.match("Nodes") && in.readInt(l.v1)) return L_NODES;
+		break;
+
+	case 'E':
+		if(in.match("Edges") && in.readInt(l.v1)) return L_EDGES;
+		if(in.match("E") && in.readInt(l.v1) && in.readInt(l.v2)) return L_EDGE;
+		break;
+
+	case 'A':
+		if(in.match("Arcs") && in.readInt(l.v1)) return L_ARCS;
+		if(in.match("A") && in.readInt(l.v1) && in.readInt(l.v2)) return L_ARC;
+		break;
+
+	case 'T':
+		if(in.match("T") && in.readInt(l.v1) && in.readDouble(l.w)) return L_TERMINAL;
+		break;
+	}
+	return L_NONE;
+}
+
+Inst loadMWCS(const char* begin, const char* end)
+{
+	int m;
+	int ij = 0;
+
 	Inst inst;
 	inst.offset = 0.0;
 	inst.r = -1;
 	inst.isInt = true;
 	inst.isMWCS = true;
-	while(fgets(buf, 256, fp) != NULL) {
+	forEachLine(begin, end, parseMWCSLine, [&](const InstLine& l) {
+		const int i = l.v1-1, j = l.v2-1;
 
-		if(sscanf(buf, "Nodes %d", &n) == 1) {
-			inst.resizeNodes(n);
-		}
-		if(sscanf(buf, "Edges %d", &m) == 1) {
-			m*=2;
+		switch(l.kind) {
+		case L_NODES:
+			inst.resizeNodes(l.v1);
+			break;
+
+		case L_EDGES:
+			m = 2*l.v1;
 			inst.resizeEdges(m);
-		}
-		if(sscanf(buf, "Arcs %d", &m) == 1) {
+			break;
+
+		case L_EDGE:
+			inst.defineArc(i, j, ij, ij+1, 0.0); ij++;
+			inst.defineArc(j, i, ij, ij-1, 0.0); ij++;
+			break;
+
+		case L_ARCS:
+			m = l.v1;
 			inst.isAsym = true;
 			inst.resizeEdges(m);
-		}
-
-		if(sscanf(buf, "A %d %d", &v1, &v2) == 2) {
-			int i = v1-1, j = v2-1;
+			break;
 
-			inst.newArc(i, j, ij, -1, 0.0);
+		case L_ARC:
+			inst.defineArc(i, j, ij, -1, 0.0);
 			ij++;
-		}
-
-		if(sscanf(buf, "E %d %d", &v1, &v2) == 2) {
-			int i = v1-1, j = v2-1;
-
-			inst.newArc(i, j, ij, ij+1, 0.0); ij++;
-			inst.newArc(j, i, ij, ij-1, 0.0); ij++;
-		}
-
-		if(sscanf(buf, "T %d %lf", &v1, &prize) == 2) {
-			int i = v1-1;
+			break;
 
+		case L_TERMINAL: {
+			double prize = l.w;
 			inst.isInt &= (floor(prize) == prize);
-			
+
 			if(!inst.isInt) {
 				prize = floor(prize * params.precision);
 			}
 
 			inst.T[i] = true;
 			inst.p[i] = (weight_t)prize;
+			break;
 		}
-	}
 
-	assert(ij == m);
+		default:
+			break;
+		}
+	});
 
-	fclose(fp);
+	assert(ij == m);
 
+	inst.buildAdjacency(ij, params.threads);
 	inst.convertMWCS2PCSTP();
 
 	return inst;
 }
 
-Inst loadNWSTP(const char* fn)
+static LineKind parseNWSTPLine(LineReader& in, InstLine& l)
 {
-	FILE *fp;
-	char buf[256];
-	int n, m, t, v1, v2, r;
-	double w, prize;
-	int ij = 0;
-
-	if((fp=fopen(fn, "r")) == NULL) {
-		EXIT("error: file not found: %s\n", fn);
+	switch(in.first()) {
+	case 'F':
+		if(in.match("Fixed") && in.readDouble(l.w)) return L_FIXED;
+		break;
+
+	case 'N':
+		if(in.match("Nodes") && in.readInt(l.v1)) return L_NODES;
+		if(in.match("NW") && in.readDouble(l.w)) return L_NODEWEIGHT;
+		break;
+
+	case 'E':
+		if(in.match("Edges") && in.readInt(l.v1)) return L_EDGES;
+		if(in.match("E") && in.readInt(l.v1) && in.readInt(l.v2) && in.readDouble(l.w)) return L_EDGE;
+		if(in.match("END")) return L_END;
+		break;
+
+	case 'T':
+		if(in.match("Terminals") && in.readInt(l.v1)) return L_TERMINALS;
+		if(in.match("T") && in.readInt(l.v1)) return L_TERMINAL;
+		break;
 	}
+	return L_NONE;
+}
+
+Inst loadNWSTP(const char* begin, const char* end)
+{
+	int m;
+	double prize;
+	int ij = 0;
 
 	Inst inst;
 	inst.offset = 0;
@@ -166,101 +396,133 @@ Inst loadNWSTP(const char* fn)
 	bool finishedT = false;
 	int nwcounter = 0;
 	vector<double> nw;
-	while(fgets(buf, 256, fp) != NULL) {
+	vector<int> nwArcs;
+	forEachLine(begin, end, parseNWSTPLine, [&](const InstLine& l) {
+		const int i = l.v1-1, j = l.v2-1;
+		double w = l.w;
 
-		if(sscanf(buf, "Fixed %lf", &w) == 1) {
+		switch(l.kind) {
+		case L_FIXED:
 			inst.offset = w;
-		}
+			break;
 
-		if(sscanf(buf, "Nodes %d", &n) == 1) {
-			inst.n = n;
-			inst.resizeNodes(n);
-			nw.resize(n, 0.0);
-		}
+		case L_NODES:
+			inst.n = l.v1;
+			inst.resizeNodes(l.v1);
+			nw.resize(l.v1, 0.0);
+			nwArcs.resize(l.v1, 0);
+			break;
 
-		if(sscanf(buf, "Edges %d", &m) == 1) {
-			m*=2;
-			inst.resizeEdges(m);
-		}
+		case L_NODEWEIGHT: {
+			const int k = nwcounter++;
 
-		if(sscanf(buf, "Terminals %d", &t) == 1) {
-			inst.t = t;
-		}
+			if(!inst.isInt) {
+				w = floor(w * params.precision);
+			}
 
-		if(sscanf(buf, "E %d %d %lf", &v1, &v2, &w) == 3) {
+			// added to the cost of the incoming arcs read so far
+			nw[k] = w;
+			nwArcs[k] = ij;
+			break;
+		}
 
-			int i = v1-1, j = v2-1;
+		case L_EDGES:
+			m = 2*l.v1;
+			inst.resizeEdges(m);
+			break;
 
+		case L_EDGE:
 			inst.isInt &= (floor(w) == w);
 
 			if(!inst.isInt) {
 				w = floor(w * params.precision);
 			}
 
-			inst.newArc(i, j, ij, ij+1, (weight_t)w); ij++;
-			inst.newArc(j, i, ij, ij-1, (weight_t)w); ij++;
-		}
+			inst.defineArc(i, j, ij, ij+1, (weight_t)w); ij++;
+			inst.defineArc(j, i, ij, ij-1, (weight_t)w); ij++;
+			break;
+
+		case L_END:
+			if(readingT) finishedT = true;
+			break;
+
+		case L_TERMINALS:
+			inst.t = l.v1;
+			break;
 
-		if(!finishedT && sscanf(buf, "T %d", &v1) == 1) {
+		case L_TERMINAL:
+			if(finishedT) break;
 			readingT = true;
-			int i = v1-1;
 
 			inst.isInt &= (floor(prize) == prize);
 			inst.T[i] = true;
 			inst.f1[i] = 1;
 			inst.p[i] = WMAX;
-		}
-
-		if(sscanf(buf, "NW %lf", &w) == 1) {
-			int i = nwcounter++;
-
-			if(!inst.isInt) {
-				w = floor(w * params.precision);
-			}
+			break;
 
-			nw[i] = w;
-			for(int ij : inst.din[i]) {
-				inst.c[ij] = inst.c[ij] + w;
-			}
+		default:
+			break;
 		}
+	});
+	
+	assert(ij == m);
 
-		if(readingT && strncmp(buf, "END", 3) == 0) {
-			finishedT = true;
+	inst.buildAdjacency(ij, params.threads);
+	for(int i = 0; i < nwcounter; i++) {
+		for(int ji : inst.din[i]) {
+			if(ji < nwArcs[i])
+				inst.c[ji] = inst.c[ji] + nw[i];
 		}
 	}
-	
+
 	for (int i = 0; i < inst.n; i++) {
 		if(inst.T[i]) {
 			inst.r = i;
 			break;
 		}
 	}
+	if(inst.r == -1) {
+		EXIT("error: instance without terminals\n");
+	}
 	
 	inst.offset += nw[inst.r];
 
-	for (int i = 0; i < inst.n; i++) {
-		inst.din[i].shrink_to_fit();
-		inst.dout[i].shrink_to_fit();
-	}
-
-	assert(ij == m);
-
-	fclose(fp);
-
 	return inst;
 }
 
-Inst loadPCSTP(const char* fn)
+static LineKind parsePCSTPLine(LineReader& in, InstLine& l)
 {
-	FILE *fp;
-	char buf[256];
-	int n, m, t, v1, v2, r;
-	double w, prize;
-	int ij = 0;
-
-	if((fp=fopen(fn, "r")) == NULL) {
-		EXIT("error: file not found: %s\n", fn);
+	switch(in.first()) {
+	case 'N':
+		if(in.match("Nodes") && in.readInt(l.v1)) return L_NODES;
+		break;
+
+	case 'E':
+		if(in.match("Edges") && in.readInt(l.v1)) return L_EDGES;
+		if(in.match("E") && in.readInt(l.v1) && in.readInt(l.v2) && in.readDouble(l.w)) return L_EDGE;
+		break;
+
+	case 'A':
+		if(in.match("Arcs") && in.readInt(l.v1)) return L_ARCS;
+		if(in.match("A") && in.readInt(l.v1) && in.readInt(l.v2) && in.readDouble(l.w)) return L_ARC;
+		break;
+
+	case 'T':
+		if(in.match("Terminals") && in.readInt(l.v1)) return L_TERMINALS;
+		if(in.match("TP") && in.readInt(l.v1) && in.readDouble(l.w)) return L_TERMINAL;
+		break;
+
+	case 'R':
+		if(in.match("RootP") && in.readInt(l.v1)) return L_ROOT;
+		break;
 	}
+	return L_NONE;
+}
+
+Inst loadPCSTP(const char* begin, const char* end)
+{
+	int m;
+	int ij = 0;
 
 	Inst inst;
 	inst.offset = 0.0;
@@ -269,70 +531,70 @@ Inst loadPCSTP(const char* fn)
 
 	vector<double> tmpW, tmpP;
 
-	while(fgets(buf, 256, fp) != NULL) {
+	forEachLine(begin, end, parsePCSTPLine, [&](const InstLine& l) {
+		const int i = l.v1-1, j = l.v2-1;
+		const double w = l.w;
 
-		if(sscanf(buf, "Nodes %d", &n) == 1) {
-			inst.resizeNodes(n);
-			tmpP.resize(n);
-		}
-
-		if(sscanf(buf, "Edges %d", &m) == 1) {
-			m*=2;
-			inst.resizeEdges(m);
-			tmpW.resize(m);
-		}
+		switch(l.kind) {
+		case L_NODES:
+			inst.resizeNodes(l.v1);
+			tmpP.resize(l.v1);
+			break;
 
-		if(sscanf(buf, "Arcs %d", &m) == 1) {
-			inst.isAsym = true;
+		case L_EDGES:
+			m = 2*l.v1;
 			inst.resizeEdges(m);
 			tmpW.resize(m);
-		}
-
-		if(sscanf(buf, "Terminals %d", &t) == 1) {
-			inst.t = t;
-		}
-
-		if(sscanf(buf, "E %d %d %lf", &v1, &v2, &w) == 3) {
-
-			int i = v1-1, j = v2-1;
+			break;
 
+		case L_EDGE:
 			inst.isInt &= (floor(w) == w);
 
-			inst.newArc(i, j, ij, ij+1, (weight_t)w);
+			inst.defineArc(i, j, ij, ij+1, (weight_t)w);
 			tmpW[ij] = w;
 			ij++;
-			inst.newArc(j, i, ij, ij-1, (weight_t)w);
+			inst.defineArc(j, i, ij, ij-1, (weight_t)w);
 			tmpW[ij] = w;
 			ij++;
-		}
-
-		if(sscanf(buf, "A %d %d %lf", &v1, &v2, &w) == 3) {
+			break;
 
-			int i = v1-1, j = v2-1;
+		case L_ARCS:
+			m = l.v1;
+			inst.isAsym = true;
+			inst.resizeEdges(m);
+			tmpW.resize(m);
+			break;
 
+		case L_ARC:
 			inst.isInt &= (floor(w) == w);
 
-			inst.newArc(i, j, ij, -1, w);
+			inst.defineArc(i, j, ij, -1, w);
 			tmpW[ij] = w;
 			ij++;
-		}
+			break;
 
-		if(sscanf(buf, "TP %d %lf", &v1, &prize) == 2) {
-			int i = v1-1;
+		case L_TERMINALS:
+			inst.t = l.v1;
+			break;
 
-			inst.isInt &= (floor(prize) == prize);
+		case L_TERMINAL:
+			inst.isInt &= (floor(w) == w);
 
 			inst.T[i] = true;
-			tmpP[i] = prize;
+			tmpP[i] = w;
 			
-			inst.p[i] = (weight_t)prize;
-		}
+			inst.p[i] = (weight_t)w;
+			break;
 
-		if(sscanf(buf, "RootP %d", &v1) == 1) {
-			inst.r = v1-1;
+		case L_ROOT:
+			inst.r = i;
 			inst.T[inst.r] = true;
+			break;
+
+		default:
+			break;
 		}
-	}
+	});
 
 	if(!inst.isInt) {
 		for (int i = 0; i < inst.n; i++) {
@@ -350,7 +612,7 @@ Inst loadPCSTP(const char* fn)
 	
 	assert(ij == m);
 
-	fclose(fp);
+	inst.buildAdjacency(ij, params.threads);
 
 	return inst;
 }
@@ -378,7 +640,7 @@ double getBestKnownBound(const char* fn, const char* boundfile)
 	return dBest;
 }
 
-void writeSolution(const char* file, Inst& inst, Sol& sol)
+string solutionText(Inst& inst, Sol& sol)
 {
 	weight_t obj = inst.offset;
 	for(int i = 0; i < inst.n; i++) {
@@ -388,36 +650,42 @@ void writeSolution(const char* file, Inst& inst, Sol& sol)
 		if(sol.arcs[i]) obj += inst.c[i];
 	}
 
-	FILE* fp;
-	if((fp=fopen(file, "w")) == NULL) {
-		EXIT("error: writing solution file: %s\n", file);
-	}
-
 	int nVertices = 0, nEdges = 0;
 	for(int i = 0; i < inst.n; i++)    if(sol.nodes[i]) nVertices++;
 	for(int ij = 0; ij < inst.m; ij++) if(sol.arcs[ij]) nEdges++;
 
-	fprintf(fp, "SECTION Comment\n");
-	fprintf(fp, "Name %s\n", stats.name.c_str());
-	fprintf(fp, "Program %s\n", PROGRAM_NAME);
-	fprintf(fp, "Version %s\n", PROGRAM_VERSION);
-	fprintf(fp, "END\n\n");
+	string text;
+	appendf(text, "SECTION Comment\n");
+	appendf(text, "Name %s\n", stats.name.c_str());
+	appendf(text, "Program %s\n", PROGRAM_NAME);
+	appendf(text, "Version %s\n", PROGRAM_VERSION);
+	appendf(text, "END\n\n");
 
-	fprintf(fp, "SECTION Solutions\n");
-	fprintf(fp, "Solution %.6lf %0.3lf\n", format(sol.obj, inst), Timer::total.elapsed().getSeconds());
-	fprintf(fp, "END\n\n");
+	appendf(text, "SECTION Solutions\n");
+	appendf(text, "Solution %.6lf %0.3lf\n", format(sol.obj, inst), Timer::total.elapsed().getSeconds());
+	appendf(text, "END\n\n");
 
-	fprintf(fp, "SECTION BestSolution\n");
-	fprintf(fp, "Vertices %d\n", nVertices);
+	appendf(text, "SECTION BestSolution\n");
+	appendf(text, "Vertices %d\n", nVertices);
 	for(int i = 0; i < inst.n; i++) {
-		if(sol.nodes[i]) fprintf(fp, "V %d\n", i+1);
+		if(sol.nodes[i]) appendf(text, "V %d\n", i+1);
 	}
-	fprintf(fp, "Edges %d\n", nEdges);
+	appendf(text, "Edges %d\n", nEdges);
 	for(int ij = 0; ij < inst.m; ij++) {
-		if(sol.arcs[ij]) fprintf(fp, "E %d %d\n", inst.tail[ij]+1, inst.head[ij]+1);
+		if(sol.arcs[ij]) appendf(text, "E %d %d\n", inst.tail[ij]+1, inst.head[ij]+1);
 	}
-	fprintf(fp, "END\n\n");
+	appendf(text, "END\n\n");
 
+	return text;
+}
+
+void writeSolution(const char* file, Inst& inst, Sol& sol)
+{
+	FILE* fp;
+	if((fp=fopen(file, "w")) == NULL) {
+		EXIT("error: writing solution file: %s\n", file);
+	}
+	fputs(solutionText(inst, sol).c_str(), fp);
 	fclose(fp);
 }
 
@@ -484,49 +752,53 @@ void recoverPartialSol(Sol& solP, Inst& inst1)
 	}
 }
 
-// converts the backmapping from a solution on a reduced instance into a partial solution on
-// the original instance
-Sol genPartialSol(Sol& sol, Inst& inst)
+SolSupport collectSolSupport(Sol& sol, Inst& inst)
 {
-	Inst& inst1 = *inst.inst1;
-	Sol sol1(inst1);
-	sol1.obj = sol.obj;
-	sol1.r = -1;
-	sol1.partial = true;
+	SolSupport s;
+	s.obj = sol.obj;
 
-	int m = 0;
 	set<int> roots;
 	for(int i = 0; i < inst.n; i++) {
 		if(!sol.nodes[i]) continue;
 		for(int a : inst.bmna[i]) {
-			sol1.nodes[inst1.tail[a]] = 1;
-			sol1.nodes[inst1.head[a]] = 1;
-			sol1.arcs[a] = 1;
-			m++;
+			s.arcs.push_back(a);
 			if(i == sol.r) {
-				roots.insert(inst1.tail[a]);
-				roots.insert(inst1.head[a]);
+				roots.insert(inst.inst1->tail[a]);
+				roots.insert(inst.inst1->head[a]);
 			}
 		}
 	}
 	for(int ij = 0; ij < inst.m; ij++) {
 		if(!sol.arcs[ij]) continue;
-		for(int a : inst.bmaa[ij]) {
-			sol1.nodes[inst1.tail[a]] = 1;
-			sol1.nodes[inst1.head[a]] = 1;
-			sol1.arcs[a] = 1;
-			m++;
-		}
+		s.arcs.insert(s.arcs.end(), inst.bmaa[ij].begin(), inst.bmaa[ij].end());
 	}
-	if(m == 0) {
+	if(s.arcs.empty()) {
 		for(int i = 0; i < inst.n; i++) {
-			if(!sol.nodes[i]) continue;
-			sol1.nodes[i] = sol.nodes[i];
+			if(sol.nodes[i]) s.nodes.push_back(i);
 		}
 	}
 	if(roots.empty()) {
 		roots.insert(sol.r);
 	}
+	s.roots.assign(roots.begin(), roots.end());
+	return s;
+}
+
+Sol expandSolSupport(const SolSupport& s, Inst& inst1)
+{
+	Sol sol1(inst1);
+	sol1.obj = s.obj;
+	sol1.r = -1;
+	sol1.partial = true;
+
+	for(int a : s.arcs) {
+		sol1.nodes[inst1.tail[a]] = 1;
+		sol1.nodes[inst1.head[a]] = 1;
+		sol1.arcs[a] = 1;
+	}
+	for(int i : s.nodes) {
+		sol1.nodes[i] = 1;
+	}
 
 	int n = 0;
 	for(int i = 0; i < inst1.n; i++) {
@@ -536,14 +808,14 @@ Sol genPartialSol(Sol& sol, Inst& inst)
 	
 	// if root not uniquely specified, infer it by finding a root form which all nodes are reachable
 	if(inst1.r != -1) {
-		for(int i : roots) {
+		for(int i : s.roots) {
 			if(i == inst1.r) {
 				sol1.r = i;
 				break;
 			}
 		}
 	} else {
-		for(int i : roots) {
+		for(int i : s.roots) {
 			int cnt = cntReachable(i, sol1, inst1);
 			
 			if(cnt == n) {
@@ -558,6 +830,61 @@ Sol genPartialSol(Sol& sol, Inst& inst)
 	return sol1;
 }
 
+// converts the backmapping from a solution on a reduced instance into a partial solution on
+// the original instance
+Sol genPartialSol(Sol& sol, Inst& inst)
+{
+	return expandSolSupport(collectSolSupport(sol, inst), *inst.inst1);
+}
+
+bool mapSolution(const Sol& sol1, Inst& inst, Sol& sol)
+{
+	const Inst& inst1 = *inst.inst1;
+	auto used = [&](int ij) -> bool {
+		if(inst.bmaa[ij].empty()) return false;
+		for(int a : inst.bmaa[ij]) {
+			if(sol1.arcs[a]) continue;
+			if(inst.isAsym || inst1.opposite[a] == -1 || !sol1.arcs[inst1.opposite[a]]) return false;
+		}
+		return true;
+	};
+
+	// the root of an unrooted instance is any remaining node of the solution, preferably its root
+	int r = inst.r;
+	if(r == -1 && sol1.r != -1 && !inst.f0[sol1.r])
+		r = sol1.r;
+	for(int i = 0; r == -1 && i < inst.n; i++) {
+		if(sol1.nodes[i] && !inst.f0[i]) r = i;
+	}
+	if(r == -1) return false;
+
+	fill(sol.arcs.begin(), sol.arcs.end(), 0);
+	fill(sol.nodes.begin(), sol.nodes.end(), 0);
+	sol.r = r;
+	sol.partial = false;
+	sol.nodes[r] = 1;
+	stack<int> Q;
+	Q.push(r);
+	while(!Q.empty()) {
+		const int i = Q.top();
+		Q.pop();
+		for(int ij : inst.dout[i]) {
+			const int j = inst.head[ij];
+			if(sol.nodes[j] || !used(ij)) continue;
+			sol.arcs[ij] = 1;
+			sol.nodes[j] = 1;
+			Q.push(j);
+		}
+	}
+
+	// fixed nodes have infinite prizes
+	for(int i = 0; i < inst.n; i++) {
+		if(inst.f1[i] && !sol.nodes[i]) return false;
+	}
+	sol.recomputeObjective();
+	return sol.validate();
+}
+
 Inst genInst(Sol& sol, Inst& inst1, vector<int>& ramap, vector<int>& rnmap)
 {
 	Inst inst0;
@@ -662,24 +989,6 @@ int cntReachable(int r, Sol& sol, Inst& inst)
 	return cnt;
 }
 
-void enlargeStack()
-{
-	const rlim_t kStackSize = 128L * 1024L * 1024L;
-	struct rlimit rl;
-	int result;
-
-	result = getrlimit(RLIMIT_STACK, &rl);
-	if(result == 0) {
-		if(rl.rlim_cur < kStackSize) {
-			rl.rlim_cur = kStackSize;
-			result = setrlimit(RLIMIT_STACK, &rl);
-			if(result != 0) {
-				fprintf(stderr, "setrlimit returned result = %d\n", result);
-			}
-		}
-	}
-}
-
 Sol loadSol(const char* fn, Inst& inst)
 {
 	FILE *fp;
@@ -745,8 +1054,7 @@ weight_t oracle(Inst& inst)
 	fp = popen(cmd, "r");
 
 	if(fp == NULL) {
-		printf("Oracle: Could not open response file.\n");
-		exit(1);
+		EXIT("error: oracle: could not open response file\n");
 	} else {
 		while(fgets(output, sizeof(output)-1, fp) != NULL) {
 			response = strtol(output, NULL, 10);